@@ -58,14 +58,23 @@ static struct Device *sana_dev = NULL;
 static UBYTE *pkt_buf = NULL;
 static ULONG pkt_buf_size;
 
+/* idle readers to load the device's reader lists */
+#define MAX_READERS   64
+#define READER_TYPE   0x88b5  /* local experimental ethertypes on */
+static struct MsgPort *idle_port = NULL;
+static struct IOSana2Req *idle_req[MAX_READERS];
+static UBYTE *idle_buf = NULL;
+static ULONG num_idle = 0;
+
 /* arg parsing */
 static char *args_template =
-  "-D=DEVICE/K,-U=UNIT/N/K,-M=MTU/N/K,-V=VERBOSE/S";
+  "-D=DEVICE/K,-U=UNIT/N/K,-M=MTU/N/K,-V=VERBOSE/S,-R=READERS/N/K";
 enum args_offset {
   DEVICE_ARG,
   UNIT_ARG,
   MTU_ARG,
   VERBOSE_ARG,
+  READERS_ARG,
   NUM_ARGS
 };
 static struct RDArgs *args_rd = NULL;
@@ -177,10 +186,76 @@ static BOOL sana_offline(void)
   return sana_cmd(S2_OFFLINE);
 }
 
+/* post CMD_READs for types that never arrive. every frame is checked
+   against them before it ends up with our orphan read */
+static BOOL post_idle_readers(ULONG num)
+{
+  ULONG i;
+
+  if(num > MAX_READERS) {
+    num = MAX_READERS;
+  }
+
+  idle_port = CreateMsgPort();
+  if(idle_port == NULL) {
+    PutStr("Error creating idle msg port!\n");
+    return FALSE;
+  }
+  idle_buf = AllocMem(pkt_buf_size, MEMF_CLEAR);
+  if(idle_buf == NULL) {
+    PutStr("Error allocating idle_buf!\n");
+    return FALSE;
+  }
+
+  for(i=0;i<num;i++) {
+    struct IOSana2Req *req;
+    req = (struct IOSana2Req *)CreateIORequest(idle_port, sizeof(struct IOSana2Req));
+    if(req == NULL) {
+      PutStr("Error creating idle IO request!\n");
+      return FALSE;
+    }
+    /* share device and buffer management of the main request */
+    *req = *sana_req;
+    req->ios2_Req.io_Message.mn_ReplyPort = idle_port;
+    req->ios2_Req.io_Command = CMD_READ;
+    req->ios2_Req.io_Flags = 0;
+    req->ios2_PacketType = READER_TYPE + i;
+    req->ios2_DataLength = pkt_buf_size;
+    req->ios2_Data = idle_buf;
+    BeginIO((struct IORequest *)req);
+    idle_req[num_idle++] = req;
+  }
+  Printf("%lu idle readers posted\n", num_idle);
+  return TRUE;
+}
+
+static void abort_idle_readers(void)
+{
+  while(num_idle > 0) {
+    struct IOSana2Req *req = idle_req[--num_idle];
+    AbortIO((struct IORequest *)req);
+    WaitIO((struct IORequest *)req);
+    DeleteIORequest(req);
+  }
+  if(idle_buf != NULL) {
+    FreeMem(idle_buf, pkt_buf_size);
+    idle_buf = NULL;
+  }
+  if(idle_port != NULL) {
+    DeleteMsgPort(idle_port);
+    idle_port = NULL;
+  }
+}
+
 static void reply_loop(void)
 {
   ULONG wmask;
   ULONG verbose = args_array[VERBOSE_ARG];
+  ULONG num_pkts = 0;
+  struct DateStamp start, end;
+  LONG ticks;
+
+  DateStamp(&start);
 
   PutStr("Waiting for incoming packets...\n");
   for(;;) {
@@ -210,6 +285,7 @@ static void reply_loop(void)
       if(verbose) {
         PutStr("+\n");
       }
+      num_pkts++;
 
       /* inconmig dst will be new src */
       memcpy(sana_req->ios2_SrcAddr, sana_req->ios2_DstAddr, SANA2_MAX_ADDR_BYTES);
@@ -227,6 +303,13 @@ static void reply_loop(void)
       }
     }
   }
+
+  /* the cpu time spent per frame in the device shows up in the rate */
+  DateStamp(&end);
+  ticks = (end.ds_Days - start.ds_Days) * 24 * 60 * 60 * TICKS_PER_SECOND +
+          (end.ds_Minute - start.ds_Minute) * 60 * TICKS_PER_SECOND +
+          (end.ds_Tick - start.ds_Tick);
+  Printf("%lu packets in %ld ticks\n", num_pkts, ticks);
 }
 
 /* ---------- main ---------- */
@@ -235,6 +318,7 @@ void __stdargs _main(char *cmdline)
   BOOL ok = TRUE;
   ULONG unit;
   ULONG mtu;
+  ULONG num;
   char *dev_name;
 
   /* parse args */
@@ -271,7 +355,16 @@ void __stdargs _main(char *cmdline)
       /* set device online */
       if(sana_online()) {
 
-        reply_loop();
+        /* optional idle readers */
+        if(args_array[READERS_ARG] != 0) {
+          num = *((ULONG *)args_array[READERS_ARG]);
+        } else {
+          num = 0;
+        }
+        if(post_idle_readers(num)) {
+          reply_loop();
+        }
+        abort_idle_readers();
 
         /* finally offline again */
         if(!sana_offline()) {
@@ -69,7 +69,10 @@ PUBLIC BOOL remtracktype(BASEPTR, ULONG type);
 PUBLIC BOOL addtracktype(BASEPTR, ULONG type);
 PUBLIC BOOL gettrackrec(BASEPTR, ULONG type, struct Sana2PacketTypeStats *info);
 PUBLIC VOID dotracktype(BASEPTR, ULONG type, ULONG ps, ULONG pr, ULONG bs, ULONG br, ULONG pd);
-PUBLIC VOID freetracktypes(BASEPTR);
+PUBLIC VOID addfiltertype(BASEPTR, ULONG type);
+PUBLIC BOOL addmcastaddr(BASEPTR, UBYTE *addr);
+PUBLIC BOOL remmcastaddr(BASEPTR, UBYTE *addr);
+PUBLIC VOID freemcastaddrs(BASEPTR);
 #define min __builtin_min
 /*E*/
 /*F*/ /* exports */
@@ -133,11 +136,12 @@ PRIVATE VOID abort(BASEPTR, struct IOSana2Req *ior);
    pb->pb_MTU = HW_ETH_MTU;
 
       /* initialise the lists */
-   NewList((struct List*)&pb->pb_ReadList);
+   for(i = 0; i < PLIP_READ_BUCKETS; i++)
+      NewList((struct List*)&pb->pb_ReadList[i]);
    NewList((struct List*)&pb->pb_WriteList);
    NewList((struct List*)&pb->pb_EventList);
    NewList((struct List*)&pb->pb_ReadOrphanList);
-   NewList((struct List*)&pb->pb_TrackList);
+   NewList((struct List*)&pb->pb_MCastList);
    NewList((struct List*)&pb->pb_BufferManagement);
 
       /* initialise the access protection semaphores */
@@ -145,7 +149,7 @@ PRIVATE VOID abort(BASEPTR, struct IOSana2Req *ior);
    InitSemaphore(&pb->pb_ReadOrphanListSem);
    InitSemaphore(&pb->pb_EventListSem);
    InitSemaphore(&pb->pb_WriteListSem);
-   InitSemaphore(&pb->pb_TrackListSem);
+   InitSemaphore(&pb->pb_MCastListSem);
    InitSemaphore(&pb->pb_Lock);
 
    pb->pb_SpecialStats[S2SS_TXERRORS].Type = S2SS_PLIP_TXERRORS;
@@ -250,6 +254,10 @@ PRIVATE VOID abort(BASEPTR, struct IOSana2Req *ior);
                               (struct TagItem *)ios2->ios2_BufferManagement);
             bm->bm_CopyFromBuffer = (BMFunc)GetTagData(S2_CopyFromBuff, NULL,
                               (struct TagItem *)ios2->ios2_BufferManagement);
+            bm->bm_DMACopyToBuffer = (DMAFunc)GetTagData(S2_DMACopyToBuff32, NULL,
+                              (struct TagItem *)ios2->ios2_BufferManagement);
+            bm->bm_DMACopyFromBuffer = (DMAFunc)GetTagData(S2_DMACopyFromBuff32, NULL,
+                              (struct TagItem *)ios2->ios2_BufferManagement);
 #else
             /*
             ** The type casting below is very beautiful. This is a SAS/C bug:
@@ -267,6 +275,10 @@ PRIVATE VOID abort(BASEPTR, struct IOSana2Req *ior);
                               (struct TagItem *)ios2->ios2_BufferManagement)));
             bm->bm_CopyFromBuffer = (BMFunc)((void (*)())(GetTagData(S2_CopyFromBuff, NULL,
                               (struct TagItem *)ios2->ios2_BufferManagement)));
+            bm->bm_DMACopyToBuffer = (DMAFunc)((void (*)())(GetTagData(S2_DMACopyToBuff32, NULL,
+                              (struct TagItem *)ios2->ios2_BufferManagement)));
+            bm->bm_DMACopyFromBuffer = (DMAFunc)((void (*)())(GetTagData(S2_DMACopyFromBuff32, NULL,
+                              (struct TagItem *)ios2->ios2_BufferManagement)));
 #endif
             d(("starting servertask\n"));
             if (!pb->pb_Server)
@@ -423,8 +435,8 @@ PRIVATE VOID abort(BASEPTR, struct IOSana2Req *ior);
       }
       d2(("server task has gone\n"));
 
-         /* clean up track */
-      freetracktypes(pb);
+         /* clean up multicast */
+      freemcastaddrs(pb);
 
       CloseLibrary(UtilityBase);
       CloseLibrary(DOSBase);
@@ -510,8 +522,10 @@ PRIVATE VOID abort(BASEPTR, struct IOSana2Req *ior);
          else
          {
             ios2->ios2_Req.io_Flags &= ~SANA2IOF_QUICK;
+            addfiltertype(pb, ios2->ios2_PacketType);
             ObtainSemaphore(&pb->pb_ReadListSem);
-            AddTail((struct List*)&pb->pb_ReadList, (struct Node*)ios2);
+            AddTail((struct List*)&pb->pb_ReadList[PLIP_READ_BUCKET(ios2->ios2_PacketType)],
+                    (struct Node*)ios2);
             ReleaseSemaphore(&pb->pb_ReadListSem);
             ios2 = NULL;
          }
@@ -521,6 +535,7 @@ PRIVATE VOID abort(BASEPTR, struct IOSana2Req *ior);
               /* set broadcast addr: ff:ff:ff:ff:ff:ff */
          memset(ios2->ios2_DstAddr, 0xff, HW_ADDRFIELDSIZE);
               /* fall through */
+      case S2_MULTICAST:
       case CMD_WRITE:
               /* determine max valid size */
          mtu = pb->pb_MTU;
@@ -531,6 +546,12 @@ PRIVATE VOID abort(BASEPTR, struct IOSana2Req *ior);
          {
             ios2->ios2_Req.io_Error = S2ERR_MTU_EXCEEDED;
          }
+         else if ((ios2->ios2_Req.io_Command == S2_MULTICAST) &&
+                  !(ios2->ios2_DstAddr[0] & 1))
+         {
+            ios2->ios2_Req.io_Error = S2ERR_BAD_ADDRESS;
+            ios2->ios2_WireError = S2WERR_BAD_MULTICAST;
+         }
          else if (ios2->ios2_BufferManagement == NULL)
          {
             ios2->ios2_Req.io_Error = S2ERR_BAD_ARGUMENT;
@@ -620,6 +641,8 @@ PRIVATE VOID abort(BASEPTR, struct IOSana2Req *ior);
          {
             ios2->ios2_Req.io_Error = S2ERR_NO_RESOURCES;
          }
+         else
+            addfiltertype(pb, ios2->ios2_PacketType);
       break;
 
       case S2_UNTRACKTYPE:
@@ -652,6 +675,7 @@ PRIVATE VOID abort(BASEPTR, struct IOSana2Req *ior);
          else
          {                       /* Enqueue it to the orphan-reader-list */
             ios2->ios2_Req.io_Flags &= ~SANA2IOF_QUICK;
+            addfiltertype(pb, ~0);
             ObtainSemaphore(&pb->pb_ReadOrphanListSem);
             AddTail((struct List*)&pb->pb_ReadOrphanList, (struct Node*)ios2);
             ReleaseSemaphore(&pb->pb_ReadOrphanListSem);
@@ -681,6 +705,28 @@ PRIVATE VOID abort(BASEPTR, struct IOSana2Req *ior);
       }
       break;
 
+      /* --------------- multicast support ----------------------- */
+
+      case S2_ADDMULTICASTADDRESS:
+         if (!(ios2->ios2_SrcAddr[0] & 1))
+         {
+            ios2->ios2_Req.io_Error = S2ERR_BAD_ADDRESS;
+            ios2->ios2_WireError = S2WERR_BAD_MULTICAST;
+         }
+         else if (!addmcastaddr(pb, ios2->ios2_SrcAddr))
+         {
+            ios2->ios2_Req.io_Error = S2ERR_NO_RESOURCES;
+         }
+      break;
+
+      case S2_DELMULTICASTADDRESS:
+         if (!remmcastaddr(pb, ios2->ios2_SrcAddr))
+         {
+            ios2->ios2_Req.io_Error = S2ERR_BAD_STATE;
+            ios2->ios2_WireError = S2WERR_BAD_MULTICAST;
+         }
+      break;
+
       /* --------------- unsupported requests -------------------- */
 
          /* all standard commands we don't support */
@@ -695,9 +741,6 @@ PRIVATE VOID abort(BASEPTR, struct IOSana2Req *ior);
       break;
 
          /* other commands (SANA-2) we don't support */
-      /*case S2_ADDMULTICASTADDRESS:*/
-      /*case S2_DELMULTICASTADDRESS:*/
-      /*case S2_MULTICAST:*/
       default:
          ios2->ios2_Req.io_Error = S2ERR_NOT_SUPPORTED;
          ios2->ios2_WireError = S2WERR_GENERIC_ERROR;
@@ -726,7 +769,9 @@ PRIVATE VOID abort(BASEPTR, struct IOSana2Req *ior);
    if (is) goto leave;
 
    ObtainSemaphore(&pb->pb_ReadListSem);
-   if (is = isinlist((struct Node*)ior, (struct List*)&pb->pb_ReadList)) abort(pb,ior);
+   if (is = isinlist((struct Node*)ior,
+                     (struct List*)&pb->pb_ReadList[PLIP_READ_BUCKET(ior->ios2_PacketType)]))
+      abort(pb,ior);
    ReleaseSemaphore(&pb->pb_ReadListSem);
    if (is) goto leave;
 
@@ -39,23 +39,32 @@
 #define SERVERTASKNAME           pb->pb_DevNode.lib_Node.ln_Name
 
 struct TrackRec {
-   struct MinNode              tr_Link;
    ULONG                       tr_PacketType;
-   ULONG                       tr_Count;
+   UWORD                       tr_Count;           /* 0: slot is free */
+   UWORD                       tr_Used;  /* slot was taken: keep probing */
    struct Sana2PacketTypeStats tr_Sana2PacketTypeStats;
 };
 
+struct MCastRec {
+   struct MinNode              mr_Link;
+   UBYTE                       mr_Addr[HW_ADDRFIELDSIZE];
+   UWORD                       mr_Count;
+};
+
 
 /****************************************************************************/
 
 
 typedef BOOL (* ASM BMFunc)(REG(a0) void *, REG(a1) void *, REG(d0) LONG);
+typedef ULONG * (* ASM DMAFunc)(REG(a0) void *);
 
 struct BufferManagement
 {
     struct MinNode   bm_Node;
     BMFunc           bm_CopyFromBuffer;
     BMFunc           bm_CopyToBuffer;
+    DMAFunc          bm_DMACopyFromBuffer;            /* optional */
+    DMAFunc          bm_DMACopyToBuffer;              /* optional */
 };
 
 
@@ -96,6 +105,19 @@ enum { S2SS_TXERRORS, S2SS_COLLISIONS, S2SS_COUNT };
 /****************************************************************************/
 
 
+   /*
+   ** the readers are kept in buckets by packet type, so a frame only
+   ** has to be compared with the readers of its bucket
+   */
+#define PLIP_TYPE_HASH(t,n)   ((((t) >> 8) ^ (t)) & ((n) - 1))
+#define PLIP_READ_BUCKETS     8
+#define PLIP_READ_BUCKET(t)   PLIP_TYPE_HASH(t, PLIP_READ_BUCKETS)
+
+   /*
+   ** tracked types live in an open addressed table (linear probing)
+   */
+#define PLIP_TRACK_MAX        16
+
 struct PLIPBase
 {
    struct Library              pb_DevNode;        /* basic device structure */
@@ -113,17 +135,17 @@ struct PLIPBase
    struct Sana2DeviceStats     pb_DevStats;            /* SANA-2 wants this */
    struct Sana2SpecialStatRecord
                                pb_SpecialStats[S2SS_COUNT];
-   volatile struct List        pb_ReadList,                  /* the readers */
-                               pb_WriteList,                 /* the writers */
+   volatile struct List        pb_ReadList[PLIP_READ_BUCKETS]; /* readers */
+   volatile struct List        pb_WriteList,                 /* the writers */
                                pb_EventList,              /* event tracking */
                                pb_ReadOrphanList,   /* for spurious packets */
-                               pb_TrackList,                  /* track type */
+                               pb_MCastList,        /* multicast addresses */
                                pb_BufferManagement;          /* Copy-In/Out */
    struct SignalSemaphore      pb_EventListSem,     /* protection for lists */
                                pb_ReadListSem,
                                pb_WriteListSem,
-                               pb_TrackListSem,
                                pb_ReadOrphanListSem,
+                               pb_MCastListSem,
                                pb_Lock;
 
    volatile UBYTE              pb_Flags;                       /* see below */
@@ -133,8 +155,14 @@ struct PLIPBase
    UBYTE                       pb_DefAddr[HW_ADDRFIELDSIZE];
    struct HWBase               pb_HWBase;
    struct HWFrame        *     pb_Frame;
+   struct HWFrame        *     pb_CtlFrame;           /* magic frames */
    ULONG                       pb_BPS;
    ULONG                       pb_MTU;
+   UWORD                       pb_FilterTypes[HW_FILTER_MAX]; /* read types */
+   UBYTE                       pb_FilterNum;     /* or PLIP_FILTER_ALL */
+   UBYTE                       pb_pad3;
+   struct TrackRec             pb_TrackTab[PLIP_TRACK_MAX];  /* type stats */
+   volatile UWORD              pb_TrackNum;          /* used slots in it */
 };
 
 #ifdef __SASC
@@ -167,11 +195,20 @@ struct PLIPBase
 #define PLIPB_EXCLUSIVE       1   /* current opener is exclusive */
 #define PLIPB_OFFLINE         2   /* currently not online (sic!) */
 #define PLIPB_SERVERSTOPPED   3   /* set by server while passing away */
+#define PLIPB_FILTER          4   /* read types changed: send filter magic */
+#define PLIPB_MCAST           5   /* groups changed: send mcast magic */
 
 #define PLIPF_REPLYSS         (1<<PLIPB_REPLYSS)
 #define PLIPF_EXCLUSIVE       (1<<PLIPB_EXCLUSIVE)
 #define PLIPF_OFFLINE         (1<<PLIPB_OFFLINE)
 #define PLIPF_SERVERSTOPPED   (1<<PLIPB_SERVERSTOPPED)
+#define PLIPF_FILTER          (1<<PLIPB_FILTER)
+#define PLIPF_MCAST           (1<<PLIPB_MCAST)
+
+   /*
+   ** pb_FilterNum if an orphan reader or too many types want all packets
+   */
+#define PLIP_FILTER_ALL       0xff
 
    /*
    ** Values for PLIPBase->pb_ExtFlags
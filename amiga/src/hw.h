@@ -8,6 +8,34 @@
 #define HW_MAGIC_ONLINE    0xffff
 #define HW_MAGIC_OFFLINE   0xfffe
 #define HW_MAGIC_LOOPBACK  0xfffd
+#define HW_MAGIC_CAPS      0xfffc
+#define HW_MAGIC_CALIB     0xfffb
+#define HW_MAGIC_FILTER    0xfffa
+#define HW_MAGIC_MCAST     0xfff9
+
+   /* TLV list (tag, len, value) behind the header of magic frames.
+      the online magic offers our caps and plipbox replies with a caps
+      magic holding the ones it agrees on */
+#define HW_TLV_END         0
+#define HW_TLV_VERSION     1      /* major, minor */
+#define HW_TLV_CAPS        2      /* capability bits below */
+#define HW_TLV_TYPES       3      /* packet types we read (words) */
+#define HW_TLV_MCAST       4      /* multicast addresses (6 bytes each) */
+
+   /* capabilities */
+#define HW_CAP_RECV_MULTI  0x01   /* several frames per receive */
+#define HW_CAP_SEND_MULTI  0x02   /* several frames per send */
+#define HW_CAP_STROBE      0x04   /* data clocked by CIA /STROBE */
+#define HW_CAP_CALIB       0x08   /* echo burst delay calibration frames */
+#define HW_CAP_CRC         0x10   /* crc trailer on single frame bursts */
+#define HW_CAP_BURST       0x20   /* burst transfers */
+#define HW_CAP_FILTER      0x40   /* plipbox filters by our read types */
+#define HW_CAP_MCAST       0x80   /* plipbox hashes our multicast groups */
+
+   /* max types in a filter magic. an empty list passes all types */
+#define HW_FILTER_MAX      8
+   /* max addresses in a mcast magic. more are sent as all groups */
+#define HW_MCAST_MAX       16
 
    /* transport ethernet addresses */
 #define HW_ADDRFIELDSIZE         6
@@ -24,6 +52,19 @@ struct HWFrame {
    /*UBYTE    hwf_Data[MTU];*/
 };
 
+/* a multi transfer stores the frames back to back in the frame buffer.
+   each frame starts word aligned and a frame of size 0 ends the list. */
+#define HW_MULTI_MAX             4
+#define HW_NEXT_FRAME(f)  ((struct HWFrame *)((UBYTE *)(f) + sizeof(USHORT) + \
+                                              (((f)->hwf_Size + 1) & ~1)))
+#define HW_FRAME_BUF_SIZE(mtu) \
+   (HW_MULTI_MAX * ((ULONG)sizeof(struct HWFrame) + (mtu) + 1) + sizeof(USHORT))
+/* magic frames have their own buffer: they are sent while the received
+   frames in the frame buffer are still dispatched. the mcast list is the
+   largest TLV list */
+#define HW_CTL_FRAME_SIZE \
+   ((ULONG)sizeof(struct HWFrame) + 2 + HW_MCAST_MAX * HW_ADDRFIELDSIZE + 1)
+
 /* ----- config stuff ----- */
 #define COMMON_TEMPLATE "NOSPECIALSTATS/S,PRIORITY=PRI/K/N,BPS/K/N,MTU/K/N,"
 
@@ -48,10 +89,17 @@ GLOBAL REGARGS VOID hw_detach(struct PLIPBase *pb);
 
 GLOBAL REGARGS BOOL hw_send_frame(struct PLIPBase *pb, struct HWFrame *frame);
 GLOBAL REGARGS BOOL hw_send_magic_pkt(struct PLIPBase *pb, USHORT magic);
+GLOBAL REGARGS BOOL hw_send_filter_pkt(struct PLIPBase *pb, UWORD *types, UWORD num);
+GLOBAL REGARGS BOOL hw_send_mcast_pkt(struct PLIPBase *pb, UBYTE *addrs, UWORD num);
+GLOBAL REGARGS UWORD hw_send_max_frames(struct PLIPBase *pb);
+GLOBAL REGARGS BOOL hw_send_dma(struct PLIPBase *pb);
+GLOBAL REGARGS BOOL hw_send_frames(struct PLIPBase *pb, struct HWFrame *frames, UWORD dma);
+GLOBAL REGARGS BOOL hw_send_single(struct PLIPBase *pb, struct HWFrame *frame, BOOL dma);
 
 GLOBAL REGARGS ULONG hw_recv_sigmask(struct PLIPBase *pb);
 GLOBAL REGARGS BOOL hw_recv_pending(struct PLIPBase *pb);
 GLOBAL REGARGS BOOL hw_recv_frame(struct PLIPBase *pb, struct HWFrame *frame);
+GLOBAL REGARGS VOID hw_recv_caps_pkt(struct PLIPBase *pb, struct HWFrame *frame);
 
 GLOBAL REGARGS void hw_config_init(struct PLIPBase *pb);
 GLOBAL REGARGS void hw_config_update(struct PLIPBase *pb, struct TemplateConfig *cfg);
@@ -0,0 +1,170 @@
+/*F*/ /* includes */
+#ifndef CLIB_EXEC_PROTOS_H
+#include <clib/exec_protos.h>
+#include <pragmas/exec_sysbase_pragmas.h>
+#endif
+
+#ifndef EXEC_MEMORY_H
+#include <exec/memory.h>
+#endif
+#ifndef EXEC_LISTS_H
+#include <exec/lists.h>
+#endif
+#ifndef EXEC_NODES_H
+#include <exec/nodes.h>
+#endif
+#ifndef DOS_DOS_H
+#include <dos/dos.h>
+#endif
+
+#ifndef _STRING_H
+#include <string.h>
+#endif
+
+#ifndef __GLOBAL_H
+#include "global.h"
+#endif
+
+#ifndef __DEBUG_H
+#include "debug.h"
+#endif
+
+/*E*/
+/*F*/ /* exports */
+PUBLIC BOOL addmcastaddr(BASEPTR, UBYTE *addr);
+PUBLIC BOOL remmcastaddr(BASEPTR, UBYTE *addr);
+PUBLIC BOOL ismcastaddr(BASEPTR, UBYTE *addr);
+PUBLIC UWORD getmcastaddrs(BASEPTR, UBYTE *addrs, UWORD max);
+PUBLIC VOID freemcastaddrs(BASEPTR);
+/*E*/
+/*F*/ /* private */
+PRIVATE struct MCastRec *findmcastaddr(BASEPTR, UBYTE *addr);
+PRIVATE VOID mcastchanged(BASEPTR);
+/*E*/
+
+/*F*/ PRIVATE INLINE struct MCastRec *findmcastaddr(BASEPTR, UBYTE *addr)
+{
+   struct MCastRec * mr;
+
+   for (mr = (struct MCastRec *) pb->pb_MCastList.lh_Head; mr->mr_Link.mln_Succ;
+                                                      mr = (struct MCastRec *) mr->mr_Link.mln_Succ)
+   {
+      if (!memcmp(mr->mr_Addr, addr, HW_ADDRFIELDSIZE))
+         return( mr );
+   }
+
+   return( NULL );
+}
+/*E*/
+   /*
+   ** the server sends the new group list to plipbox
+   */
+/*F*/ PRIVATE VOID mcastchanged(BASEPTR)
+{
+   Forbid();
+   pb->pb_Flags |= PLIPF_MCAST;
+   Signal((struct Task*)pb->pb_Server, SIGBREAKF_CTRL_F);
+   Permit();
+}
+/*E*/
+/*F*/ PUBLIC BOOL addmcastaddr(BASEPTR, UBYTE *addr)
+{
+   struct MCastRec *mr;
+   BOOL rv = FALSE, changed = FALSE;
+
+   ObtainSemaphore(&pb->pb_MCastListSem);
+   if (!(mr = findmcastaddr(pb, addr)))
+   {
+      if (mr = AllocVec(sizeof(*mr), MEMF_CLEAR))
+      {
+         mr->mr_Count = 1;
+         memcpy(mr->mr_Addr, addr, HW_ADDRFIELDSIZE);
+         AddTail((struct List*)&pb->pb_MCastList, (struct Node *)mr);
+         rv = changed = TRUE;
+      }
+   }
+   else
+   {
+      ++mr->mr_Count;
+      rv = TRUE;
+   }
+   ReleaseSemaphore(&pb->pb_MCastListSem);
+
+   if (changed)
+      mcastchanged(pb);
+
+   return rv;
+}
+/*E*/
+/*F*/ PUBLIC BOOL remmcastaddr(BASEPTR, UBYTE *addr)
+{
+   struct MCastRec *mr;
+   BOOL rv = FALSE, changed = FALSE;
+
+   ObtainSemaphore(&pb->pb_MCastListSem);
+   if (mr = findmcastaddr(pb, addr))
+   {
+      if (!(--mr->mr_Count))
+      {
+         Remove((struct Node *)mr);
+         FreeVec(mr);
+         changed = TRUE;
+      }
+      rv = TRUE;
+   }
+   ReleaseSemaphore(&pb->pb_MCastListSem);
+
+   if (changed)
+      mcastchanged(pb);
+
+   return rv;
+}
+/*E*/
+/*F*/ PUBLIC BOOL ismcastaddr(BASEPTR, UBYTE *addr)
+{
+   BOOL rv;
+
+   ObtainSemaphoreShared(&pb->pb_MCastListSem);
+   rv = findmcastaddr(pb, addr) ? TRUE : FALSE;
+   ReleaseSemaphore(&pb->pb_MCastListSem);
+
+   return rv;
+}
+/*E*/
+   /*
+   ** copy up to max addresses. returns max + 1 if there are more
+   */
+/*F*/ PUBLIC UWORD getmcastaddrs(BASEPTR, UBYTE *addrs, UWORD max)
+{
+   struct MCastRec * mr;
+   UWORD num = 0;
+
+   ObtainSemaphoreShared(&pb->pb_MCastListSem);
+   for (mr = (struct MCastRec *) pb->pb_MCastList.lh_Head; mr->mr_Link.mln_Succ;
+                                                      mr = (struct MCastRec *) mr->mr_Link.mln_Succ)
+   {
+      if (num == max)
+      {
+         num++;
+         break;
+      }
+      memcpy(addrs, mr->mr_Addr, HW_ADDRFIELDSIZE);
+      addrs += HW_ADDRFIELDSIZE;
+      num++;
+   }
+   ReleaseSemaphore(&pb->pb_MCastListSem);
+
+   return num;
+}
+/*E*/
+/*F*/ PUBLIC VOID freemcastaddrs(BASEPTR)
+{
+   struct Node *mr;
+
+   ObtainSemaphore(&pb->pb_MCastListSem);
+   while(mr = RemHead((struct List*)&pb->pb_MCastList))
+      FreeVec(mr);
+   ReleaseSemaphore(&pb->pb_MCastListSem);
+}
+/*E*/
+
@@ -42,6 +42,9 @@
 #ifndef EXEC_IO_H
 #include <exec/io.h>
 #endif
+#ifndef EXEC_EXECBASE_H
+#include <exec/execbase.h>
+#endif
 
 #ifndef DEVICES_SANA2_H
 #include <devices/sana2.h>
@@ -80,11 +83,16 @@ GLOBAL BOOL ASM hwsend(REG(a0) struct HWBase *hwb, REG(a1) struct HWFrame *frame
 GLOBAL BOOL ASM hwrecv(REG(a0) struct HWBase *hwb, REG(a1) struct HWFrame *frame);
 GLOBAL BOOL ASM hwburstsend(REG(a0) struct HWBase *, REG(a1) struct HWFrame *);
 GLOBAL BOOL ASM hwburstrecv(REG(a0) struct HWBase *, REG(a1) struct HWFrame *);
+GLOBAL BOOL ASM hwburstrecvmulti(REG(a0) struct HWBase *, REG(a1) struct HWFrame *);
+GLOBAL BOOL ASM hwburstsendmulti(REG(a0) struct HWBase *, REG(a1) struct HWFrame *);
+GLOBAL BOOL ASM hwstrobesend(REG(a0) struct HWBase *, REG(a1) struct HWFrame *);
+GLOBAL BOOL ASM hwstroberecv(REG(a0) struct HWBase *, REG(a1) struct HWFrame *);
 
    /* amiga.lib provides for these symbols */
 GLOBAL FAR volatile struct CIA ciaa,ciab;
 
-PRIVATE ULONG ASM SAVEDS exceptcode(REG(d0) ULONG sigmask, REG(a1) struct PLIPBase *hwb);
+PRIVATE REGARGS VOID update_timeout(struct HWBase *hwb);
+PRIVATE REGARGS VOID start_timeout(struct HWBase *hwb);
 
 /* CIA access macros & functions */
 #define CLEARINT        SetICR(CIAABase, CIAICRF_FLG)
@@ -106,24 +114,167 @@ PRIVATE ULONG ASM SAVEDS exceptcode(REG(d0) ULONG sigmask, REG(a1) struct PLIPBa
 #define SETREQUEST(b)   ciab.ciapra |= HS_REQ_MASK
 #define CLEARREQUEST(b) ciab.ciapra &= ~HS_REQ_MASK
 
+/* capabilities we announce to plipbox */
+PRIVATE REGARGS UBYTE own_caps(struct HWBase *hwb)
+{
+   UBYTE caps;
+
+   /* all fast transfers are based on burst. filters work with all */
+   if(!hwb->hwb_BurstMode) {
+      return HW_CAP_FILTER | HW_CAP_MCAST;
+   }
+   caps = HW_CAP_FILTER | HW_CAP_MCAST |
+          HW_CAP_BURST | HW_CAP_RECV_MULTI | HW_CAP_SEND_MULTI;
+   /* strobe and crc are only offered on request */
+   if(hwb->hwb_StrobeMode) {
+      caps |= HW_CAP_STROBE;
+   } else {
+      /* the firmware tunes its burst delay with our echo */
+      caps |= HW_CAP_CALIB;
+   }
+   if(hwb->hwb_CrcMode) {
+      caps |= HW_CAP_CRC;
+   }
+   return caps;
+}
+
+/* pick the transfer engine from the agreed caps */
+PRIVATE REGARGS VOID select_engine(struct HWBase *hwb)
+{
+   UBYTE caps = hwb->hwb_Caps;
+
+   if(caps & HW_CAP_STROBE) {
+      hwb->hwb_Engine = HW_ENGINE_STROBE;
+   } else if(caps & HW_CAP_CRC) {
+      hwb->hwb_Engine = HW_ENGINE_CRC;
+   } else if((caps & HW_CAP_RECV_MULTI) && (caps & HW_CAP_SEND_MULTI)) {
+      hwb->hwb_Engine = HW_ENGINE_MULTI;
+   } else if(caps & HW_CAP_BURST) {
+      hwb->hwb_Engine = HW_ENGINE_BURST;
+   } else if(caps == 0 && hwb->hwb_BurstMode) {
+      /* no reply (yet): burst is understood by all firmwares */
+      hwb->hwb_Engine = HW_ENGINE_BURST;
+   } else {
+      hwb->hwb_Engine = HW_ENGINE_PLAIN;
+   }
+
+   if(hwb->hwb_Engine == HW_ENGINE_CRC) {
+      hwb->hwb_Flags |= HWF_BURST_CRC;
+   } else {
+      hwb->hwb_Flags &= ~HWF_BURST_CRC;
+   }
+   d(("engine %ld\n", (ULONG)hwb->hwb_Engine));
+}
+
+/* find value of a tag in the TLV list behind the header of a magic frame */
+PRIVATE REGARGS UBYTE *find_tlv(struct HWFrame *frame, UBYTE tag, UBYTE min_len)
+{
+   UBYTE *ptr = (UBYTE *)(frame + 1);
+   UBYTE *end = (UBYTE *)frame->hwf_DstAddr + frame->hwf_Size;
+
+   while(ptr + 2 <= end) {
+      UBYTE t = ptr[0];
+      UBYTE l = ptr[1];
+      if((t == HW_TLV_END) || (ptr + 2 + l > end)) {
+         break;
+      }
+      if((t == tag) && (l >= min_len)) {
+         return ptr + 2;
+      }
+      ptr += 2 + l;
+   }
+   return NULL;
+}
+
 /* magic packet to tell plipbox firmware we go online and our MAC */
 GLOBAL REGARGS BOOL hw_send_magic_pkt(struct PLIPBase *pb, USHORT magic)
 {
+   struct HWBase *hwb = &pb->pb_HWBase;
    BOOL rc;
 
-   struct HWFrame *frame = pb->pb_Frame;
+   struct HWFrame *frame = pb->pb_CtlFrame;
+   UBYTE *tlv = (UBYTE *)(frame + 1);
+   UWORD n = 0;
    
-   frame->hwf_Size = HW_ETH_HDR_SIZE;
    memcpy(frame->hwf_SrcAddr, pb->pb_CfgAddr, HW_ADDRFIELDSIZE);
    memset(frame->hwf_DstAddr, 0, HW_ADDRFIELDSIZE);
    frame->hwf_DstAddr[0] = DEVICE_VERSION;
    frame->hwf_DstAddr[1] = DEVICE_REVISION;
    frame->hwf_Type = magic;
+
+   /* TLV list: our version and on online the caps we offer */
+   tlv[n++] = HW_TLV_VERSION;
+   tlv[n++] = 2;
+   tlv[n++] = DEVICE_VERSION;
+   tlv[n++] = DEVICE_REVISION;
+
+   /* (re-)negotiate caps: use the defaults until plipbox replies */
+   if(magic == HW_MAGIC_ONLINE) {
+      hwb->hwb_Caps = 0;
+      select_engine(hwb);
+      tlv[n++] = HW_TLV_CAPS;
+      tlv[n++] = 1;
+      tlv[n++] = own_caps(hwb);
+   }
+   tlv[n++] = HW_TLV_END;
+
+   frame->hwf_Size = HW_ETH_HDR_SIZE + n;
    
    rc = hw_send_frame(pb, frame) ? TRUE : FALSE;
    return rc;
 }
 
+GLOBAL REGARGS BOOL hw_send_filter_pkt(struct PLIPBase *pb, UWORD *types, UWORD num)
+{
+   struct HWFrame *frame = pb->pb_CtlFrame;
+   UBYTE *tlv = (UBYTE *)(frame + 1);
+   UWORD i, n = 0;
+
+   memcpy(frame->hwf_SrcAddr, pb->pb_CfgAddr, HW_ADDRFIELDSIZE);
+   memset(frame->hwf_DstAddr, 0, HW_ADDRFIELDSIZE);
+   frame->hwf_Type = HW_MAGIC_FILTER;
+
+   /* the types we read. an empty list lets all pass */
+   tlv[n++] = HW_TLV_TYPES;
+   tlv[n++] = num * 2;
+   for(i=0;i<num;i++) {
+      tlv[n++] = types[i] >> 8;
+      tlv[n++] = types[i];
+   }
+   tlv[n++] = HW_TLV_END;
+
+   frame->hwf_Size = HW_ETH_HDR_SIZE + n;
+
+   return hw_send_frame(pb, frame) ? TRUE : FALSE;
+}
+
+GLOBAL REGARGS BOOL hw_send_mcast_pkt(struct PLIPBase *pb, UBYTE *addrs, UWORD num)
+{
+   struct HWFrame *frame = pb->pb_CtlFrame;
+   UBYTE *tlv = (UBYTE *)(frame + 1);
+   UWORD n = 0;
+
+   memcpy(frame->hwf_SrcAddr, pb->pb_CfgAddr, HW_ADDRFIELDSIZE);
+   memset(frame->hwf_DstAddr, 0, HW_ADDRFIELDSIZE);
+   frame->hwf_Type = HW_MAGIC_MCAST;
+
+   /* no list: no groups. too many are sent as an empty list: all groups */
+   if(num > 0) {
+      if(num > HW_MCAST_MAX) {
+         num = 0;
+      }
+      tlv[n++] = HW_TLV_MCAST;
+      tlv[n++] = num * HW_ADDRFIELDSIZE;
+      memcpy(tlv + n, addrs, num * HW_ADDRFIELDSIZE);
+      n += num * HW_ADDRFIELDSIZE;
+   }
+   tlv[n++] = HW_TLV_END;
+
+   frame->hwf_Size = HW_ETH_HDR_SIZE + n;
+
+   return hw_send_frame(pb, frame) ? TRUE : FALSE;
+}
+
 #define PLIP_DEFTIMEOUT          (500*1000)
 #define PLIP_MINTIMEOUT          500
 #define PLIP_MAXTIMEOUT          (10000*1000)
@@ -135,6 +286,10 @@ GLOBAL REGARGS void hw_config_init(struct PLIPBase *pb)
   hwb->hwb_TimeOutSecs = PLIP_DEFTIMEOUT / 1000000L;
   hwb->hwb_TimeOutMicros = PLIP_DEFTIMEOUT % 1000000L;
   hwb->hwb_BurstMode = 1;
+  hwb->hwb_StrobeMode = 0;
+  hwb->hwb_CrcMode = 0;
+  hwb->hwb_Caps = 0;
+  select_engine(hwb);
 }
 
 GLOBAL REGARGS void hw_config_update(struct PLIPBase *pb, struct TemplateConfig *args)
@@ -145,11 +300,22 @@ GLOBAL REGARGS void hw_config_update(struct PLIPBase *pb, struct TemplateConfig
     LONG to = BOUNDS(*args->timeout, PLIP_MINTIMEOUT, PLIP_MAXTIMEOUT);
     hwb->hwb_TimeOutMicros = to % 1000000L;
     hwb->hwb_TimeOutSecs = to / 1000000L;
+    update_timeout(hwb);
   }
 
   if(args->no_burst) {
     hwb->hwb_BurstMode = 0;
   }
+
+  if(args->strobe) {
+    hwb->hwb_StrobeMode = 1;
+  }
+
+  if(args->crc) {
+    hwb->hwb_CrcMode = 1;
+  }
+
+  select_engine(hwb);
 }
 
 GLOBAL REGARGS void hw_config_dump(struct PLIPBase *pb)
@@ -173,51 +339,38 @@ GLOBAL REGARGS BOOL hw_init(struct PLIPBase *pb)
    hwb->hwb_MaxFrameSize = (UWORD)pb->pb_MTU + HW_ETH_HDR_SIZE;
    d2(("sysbase=%08lx, server=%08lx, hwb=%08lx, maxFrameSize=%ld\n",
       hwb->hwb_SysBase, hwb->hwb_Server, hwb, (ULONG)hwb->hwb_MaxFrameSize));
+
+   /* pick the burst kernels: unrolled ones only pay off without i-cache */
+   if(((struct ExecBase *)SysBase)->AttnFlags & AFF_68020) {
+      hwb->hwb_Flags &= ~HWF_UNROLL;
+   } else {
+      hwb->hwb_Flags |= HWF_UNROLL;
+   }
+   d(("unroll %ld\n", (ULONG)((hwb->hwb_Flags & HWF_UNROLL) != 0)));
    
    if ((hwb->hwb_IntSig = AllocSignal(-1)) != -1)
    {
       hwb->hwb_IntSigMask = 1L << hwb->hwb_IntSig;
       d2(("int sigmask=%08lx\n",hwb->hwb_IntSigMask));
    
-      if ((hwb->hwb_TimeoutPort = CreateMsgPort()))
+      if (!OpenDevice("timer.device", UNIT_ECLOCK, (struct IORequest*)&hwb->hwb_TimerReq, 0))
       {
-         ULONG sigmask;
-         struct Process *proc = pb->pb_Server;
-         
-         /* save old exception setup */
-         hwb->hwb_OldExcept = SetExcept(0, 0xffffffff); /* turn'em off */
-         hwb->hwb_OldExceptCode = proc->pr_Task.tc_ExceptCode;
-         hwb->hwb_OldExceptData = proc->pr_Task.tc_ExceptData;
-
-         /* create new exception setup */
-         proc->pr_Task.tc_ExceptCode = (APTR)&exceptcode;
-         proc->pr_Task.tc_ExceptData = (APTR)pb;
-         sigmask = 1 << hwb->hwb_TimeoutPort->mp_SigBit;
-         SetSignal(0, sigmask);
-         SetExcept(sigmask, sigmask);
-
-         /* enter port address */
-         hwb->hwb_TimeoutReq.tr_node.io_Message.mn_ReplyPort = hwb->hwb_TimeoutPort;
-         if (!OpenDevice("timer.device", UNIT_MICROHZ, (struct IORequest*)&hwb->hwb_TimeoutReq, 0))
-         {
-             TimerBase = (struct Library *)hwb->hwb_TimeoutReq.tr_node.io_Device;
-
-             /* setup the timeout stuff */
-             hwb->hwb_TimeoutReq.tr_node.io_Flags = IOF_QUICK;
-             hwb->hwb_TimeoutReq.tr_node.io_Command = TR_ADDREQUEST;
-             hwb->hwb_TimeoutSet = 0xff;
-
-             rc = TRUE;
-          }
-          else
-          {
-             d(("couldn't open timer.device"));
-          }
-       }
-       else
-       {
-          d(("no port for timeout handling\n"));
-       }
+         struct EClockVal ev;
+
+         TimerBase = (struct Library *)hwb->hwb_TimerReq.tr_node.io_Device;
+
+         /* timeouts are deadlines on the E clock polled by the asm code */
+         hwb->hwb_EClockFreq = ReadEClock(&ev);
+         update_timeout(hwb);
+         d2(("eclock=%ld, timeoutTicks=%ld\n",
+             hwb->hwb_EClockFreq, hwb->hwb_TimeoutTicks));
+
+         rc = TRUE;
+      }
+      else
+      {
+         d(("couldn't open timer.device"));
+      }
     } 
     else 
     {
@@ -231,22 +384,10 @@ GLOBAL REGARGS VOID hw_cleanup(struct PLIPBase *pb)
 {
    struct HWBase *hwb = &pb->pb_HWBase;
    
-   if (hwb->hwb_TimeoutPort)
+   if (TimerBase)
    {
-      struct Process *proc = pb->pb_Server;
-      
-      /* restore old exception setup */
-      SetExcept(0, 0xffffffff);    /* turn'em off */
-      proc->pr_Task.tc_ExceptCode = hwb->hwb_OldExceptCode;
-      proc->pr_Task.tc_ExceptData = hwb->hwb_OldExceptData;
-      SetExcept(hwb->hwb_OldExcept, 0xffffffff);
-
-      if (TimerBase)
-      {
-         WaitIO((struct IORequest*)&hwb->hwb_TimeoutReq);
-         CloseDevice((struct IORequest*)&hwb->hwb_CollReq);
-      }
-      DeleteMsgPort(hwb->hwb_TimeoutPort);
+      CloseDevice((struct IORequest*)&hwb->hwb_TimerReq);
+      TimerBase = NULL;
    }
    
    if (hwb->hwb_IntSig != -1) {
@@ -352,23 +493,24 @@ GLOBAL REGARGS VOID hw_detach(struct PLIPBase *pb)
    hwb->hwb_AllocFlags = 0;
 }
 
-PRIVATE ULONG ASM SAVEDS exceptcode(REG(d0) ULONG sigmask, REG(a1) struct PLIPBase *pb)
+/* convert the configured timeout to E clock ticks */
+PRIVATE REGARGS VOID update_timeout(struct HWBase *hwb)
 {
-   struct HWBase *hwb = &pb->pb_HWBase;
-   
-   d8(("+ex\n"));
-   
-   /*extern void KPrintF(char *,...);
-   KPrintF("exceptcode\n");*/
+   ULONG freq = hwb->hwb_EClockFreq;
 
-   /* remove the I/O Block from the port */
-   WaitIO((struct IORequest*)&hwb->hwb_TimeoutReq);
+   /* micros * freq would overflow: go via ticks per ms */
+   hwb->hwb_TimeoutTicks = hwb->hwb_TimeOutSecs * freq +
+                           (hwb->hwb_TimeOutMicros * (freq / 1000)) / 1000;
+}
 
-   /* this tells the xfer routines to cease polling */
-   hwb->hwb_TimeoutSet = 0xff;
-   
-   d8(("-ex\n"));
-   return sigmask;            /* re-enable the signal */
+/* arm the timeout of the next transfer. the deadline itself is only set
+   when a wait loop runs out of polls (see chkdeadline in hwpar.asm), so
+   fast transfers never read the clock */
+PRIVATE REGARGS VOID start_timeout(struct HWBase *hwb)
+{
+   hwb->hwb_PollCount = HW_POLL_COUNT;
+   hwb->hwb_DeadlineSet = 0;
+   hwb->hwb_TimeoutSet = 0;
 }
 
 GLOBAL REGARGS BOOL hw_send_frame(struct PLIPBase *pb, struct HWFrame *frame)
@@ -376,28 +518,77 @@ GLOBAL REGARGS BOOL hw_send_frame(struct PLIPBase *pb, struct HWFrame *frame)
    struct HWBase *hwb = &pb->pb_HWBase;
    BOOL rc;
 
-   /* wait until I/O block is safe to be reused */
-   while(!hwb->hwb_TimeoutSet) Delay(1L);
-   
-   /* start new timeout timer */
-   hwb->hwb_TimeoutReq.tr_time.tv_secs = hwb->hwb_TimeOutSecs;
-   hwb->hwb_TimeoutReq.tr_time.tv_micro = hwb->hwb_TimeOutMicros;
-   hwb->hwb_TimeoutSet = 0;
-   SendIO((struct IORequest*)&hwb->hwb_TimeoutReq);
+   start_timeout(hwb);
 
    /* hw send */
-   if(hwb->hwb_BurstMode) {
+   if(hwb->hwb_Engine == HW_ENGINE_STROBE) {
+     d8(("+txs\n"));
+     rc = hwstrobesend(hwb, frame);
+   } else if(hwb->hwb_Engine != HW_ENGINE_PLAIN) {
      d8(("+txb\n"));
+     if(hwb->hwb_Engine == HW_ENGINE_CRC) {
+       hwb->hwb_BurstCrc = CRC16(frame->hwf_DstAddr,
+                                 (frame->hwf_Size + 1) & ~1);
+     }
      rc = hwburstsend(hwb, frame);
    } else {
      d8(("+tx\n"));
      rc = hwsend(hwb, frame);
    }
    d8(("-tx: %s\n", rc ? "ok":"ERR"));
-      
-   /* stop timeout timer */ 
-   AbortIO((struct IORequest*)&hwb->hwb_TimeoutReq);
-   
+
+   return rc;
+}
+
+/* how many frames hw_send_frames() can take */
+GLOBAL REGARGS UWORD hw_send_max_frames(struct PLIPBase *pb)
+{
+   struct HWBase *hwb = &pb->pb_HWBase;
+   return (hwb->hwb_Engine == HW_ENGINE_MULTI) ? HW_MULTI_MAX : 1;
+}
+
+/* can the engine send the payload of a frame from the stack's buffer?
+   the frame then holds the header and the pointer to the payload */
+GLOBAL REGARGS BOOL hw_send_dma(struct PLIPBase *pb)
+{
+   struct HWBase *hwb = &pb->pb_HWBase;
+   return (hwb->hwb_Engine == HW_ENGINE_MULTI) ||
+          (hwb->hwb_Engine == HW_ENGINE_BURST);
+}
+
+/* send one frame of a hw_send_frames() list on its own */
+GLOBAL REGARGS BOOL hw_send_single(struct PLIPBase *pb, struct HWFrame *frame, BOOL dma)
+{
+   struct HWBase *hwb = &pb->pb_HWBase;
+   BOOL rc;
+
+   hwb->hwb_SendDma = dma ? 1 : 0;
+   rc = hw_send_frame(pb, frame);
+   hwb->hwb_SendDma = 0;
+   return rc;
+}
+
+/* send a list of frames terminated by size 0. bit n of dma is set if
+   frame n carries a payload pointer (see hw_send_dma()) */
+GLOBAL REGARGS BOOL hw_send_frames(struct PLIPBase *pb, struct HWFrame *frames, UWORD dma)
+{
+   struct HWBase *hwb = &pb->pb_HWBase;
+   BOOL rc;
+
+   /* single frame */
+   if(hwb->hwb_Engine != HW_ENGINE_MULTI) {
+      return hw_send_single(pb, frames, dma);
+   }
+
+   start_timeout(hwb);
+
+   /* hw send */
+   d8(("+txm\n"));
+   hwb->hwb_SendDma = dma;
+   rc = hwburstsendmulti(hwb, frames);
+   hwb->hwb_SendDma = 0;
+   d8(("-txm: %s\n", rc ? "ok":"ERR"));
+
    return rc;
 }
 
@@ -418,31 +609,58 @@ GLOBAL REGARGS BOOL hw_recv_frame(struct PLIPBase *pb, struct HWFrame *frame)
    struct HWBase *hwb = &pb->pb_HWBase;
    BOOL rc;
 
-   /* wait until I/O block is safe to be reused */
-   while(!hwb->hwb_TimeoutSet) Delay(1L);
-    
-   /* start new timeout timer */
-   hwb->hwb_TimeoutReq.tr_time.tv_secs    = hwb->hwb_TimeOutSecs;
-   hwb->hwb_TimeoutReq.tr_time.tv_micro   = hwb->hwb_TimeOutMicros;
-   hwb->hwb_TimeoutSet = 0;
-   SendIO((struct IORequest*)&hwb->hwb_TimeoutReq);
+   start_timeout(hwb);
 
    /* hw recv */
-   if(hwb->hwb_BurstMode) {
-     d8(("+rxb\n"));
-     rc = hwburstrecv(hwb, frame);
-   } else { 
-     d8(("+rx\n"));
-     rc = hwrecv(hwb, frame);
+   if(hwb->hwb_Engine == HW_ENGINE_MULTI) {
+     d8(("+rxm\n"));
+     rc = hwburstrecvmulti(hwb, frame);
+   } else {
+     if(hwb->hwb_Engine == HW_ENGINE_STROBE) {
+       d8(("+rxs\n"));
+       rc = hwstroberecv(hwb, frame);
+     } else if(hwb->hwb_Engine != HW_ENGINE_PLAIN) {
+       d8(("+rxb\n"));
+       rc = hwburstrecv(hwb, frame);
+       if(rc && frame->hwf_Size && (hwb->hwb_Engine == HW_ENGINE_CRC)) {
+         USHORT crc = CRC16(frame->hwf_DstAddr,
+                            (frame->hwf_Size + 1) & ~1);
+         if(crc != hwb->hwb_BurstCrc) {
+           d8(("crc %04lx != %04lx\n", (ULONG)crc, (ULONG)hwb->hwb_BurstCrc));
+           rc = FALSE;
+         }
+       }
+     } else { 
+       d8(("+rx\n"));
+       rc = hwrecv(hwb, frame);
+     }
+     /* terminate frame list */
+     if(rc) {
+       HW_NEXT_FRAME(frame)->hwf_Size = 0;
+     }
    }
    d8(("+rx: %s\n", rc ? "ok":"ERR"));
-    
-   /* stop timeout timer */
-   AbortIO((struct IORequest*)&hwb->hwb_TimeoutReq);
-   
+
    return rc;
 }
 
+GLOBAL REGARGS VOID hw_recv_caps_pkt(struct PLIPBase *pb, struct HWFrame *frame)
+{
+   struct HWBase *hwb = &pb->pb_HWBase;
+
+   UBYTE *ver = find_tlv(frame, HW_TLV_VERSION, 2);
+   UBYTE *caps = find_tlv(frame, HW_TLV_CAPS, 1);
+
+   if(ver != NULL) {
+      d(("plipbox firmware %ld.%ld\n", (ULONG)ver[0], (ULONG)ver[1]));
+   }
+
+   /* only use what we asked for */
+   hwb->hwb_Caps = (caps != NULL) ? (caps[0] & own_caps(hwb)) : 0;
+   d(("caps %02lx\n", (ULONG)hwb->hwb_Caps));
+   select_engine(hwb);
+}
+
 GLOBAL REGARGS ULONG hw_recv_sigmask(struct PLIPBase *pb)
 {
    struct HWBase *hwb = &pb->pb_HWBase;
@@ -17,30 +17,51 @@ struct HWBase
    UWORD                       hwb_MaxFrameSize;
    volatile UBYTE              hwb_TimeoutSet;/* if != 0, a timeout occurred */
    volatile UBYTE              hwb_Flags;
+   UWORD                       hwb_BurstCrc;  /* crc trailer of last burst */
+   UWORD                       hwb_SendDma;   /* frame bits: payload by ptr */
+   struct Library          *   hwb_TimerBase;
+   ULONG                       hwb_TimeoutTicks; /* timeout in E clock ticks */
+   ULONG                       hwb_Deadline;  /* E clock (lo) of the timeout */
+   UWORD                       hwb_PollCount; /* polls until next clock read */
+   UWORD                       hwb_DeadlineSet;
    /* NOT used in asm */
    ULONG                       hwb_IntSig;        /* sent from int to server */
    ULONG                       hwb_CollSigMask;
-   struct MsgPort          *   hwb_TimeoutPort;      /* for timeout handling */
-   struct Library          *   hwb_TimerBase;
    struct Library          *   hwb_MiscBase;          /* various libs & res. */
-   APTR                        hwb_OldExceptCode;
-   APTR                        hwb_OldExceptData;
-   ULONG                       hwb_OldExcept;
    struct Interrupt            hwb_Interrupt;          /* for AddICRVector() */
-   struct timerequest          hwb_TimeoutReq,       /* for timeout handling */
-                               hwb_CollReq;        /* for collision handling */
+   struct timerequest          hwb_TimerReq;       /* only for ReadEClock() */
+   ULONG                       hwb_EClockFreq;
    ULONG                       hwb_AllocFlags;
 
    /* config options */
    ULONG                       hwb_TimeOutMicros;
    ULONG                       hwb_TimeOutSecs;
    UWORD                       hwb_BurstMode;
+   UWORD                       hwb_StrobeMode;
+   UWORD                       hwb_CrcMode;
+
+   /* capabilities agreed with plipbox and transfer engine picked */
+   UBYTE                       hwb_Caps;
+   UBYTE                       hwb_Engine;
 };
 
+/* wait loop polls between two E clock reads */
+#define HW_POLL_COUNT              32
+
+#define HW_ENGINE_PLAIN            0
+#define HW_ENGINE_BURST            1
+#define HW_ENGINE_MULTI            2    /* several frames per burst */
+#define HW_ENGINE_CRC              3    /* single bursts with crc trailer */
+#define HW_ENGINE_STROBE           4
+
 #define HWB_RECV_PENDING           0
 #define HWB_COLL_TIMER_RUNNING     1
+#define HWB_BURST_CRC              2
+#define HWB_UNROLL                 3    /* 68000 burst kernels */
 
 #define HWF_RECV_PENDING           (1 << HWB_RECV_PENDING)
+#define HWF_BURST_CRC              (1 << HWB_BURST_CRC)
+#define HWF_UNROLL                 (1 << HWB_UNROLL)
 
 /* transparently map proto lib bases to structure */
 #define MiscBase     hwb->hwb_MiscBase
@@ -51,7 +72,7 @@ struct HWBase
 /* ----- config ----- */
 
 #define CONFIGFILE "ENV:SANA2/plipbox.config"
-#define TEMPLATE "TIMEOUT/K/N,NOBURST/S"
+#define TEMPLATE "TIMEOUT/K/N,NOBURST/S,STROBE/S,CRC/S"
 
 /* structure to be filled by ReadArgs template */ 
 struct TemplateConfig
@@ -59,6 +80,8 @@ struct TemplateConfig
    struct CommonConfig common;
    ULONG *timeout;
    ULONG no_burst;
+   ULONG strobe;
+   ULONG crc;
 };
 
 #endif
@@ -18,6 +18,11 @@
       xdef    _hwrecv
       xdef    _hwburstsend
       xdef    _hwburstrecv
+      xdef    _hwburstrecvmulti
+      xdef    _hwburstsendmulti
+      xdef    _hwstrobesend
+      xdef    _hwstroberecv
+      xdef    _CRC16
 
 
 ciaa     equ     $bfe001
@@ -43,6 +48,55 @@ SETCIAINPUT MACRO
       sf       ciaa+ciaddrb-BaseAX(\1)                ; data dir. => input
       ENDM
 
+; wait loop timeout: \1 = poll loop. the E clock is read only every
+; HW_POLL_COUNT polls. falls through if the deadline has passed.
+CHKTIMEOUT MACRO
+      subq.w   #1,hwb_PollCount(a2)
+      bne.s    \1
+      bsr      chkdeadline
+      beq.s    \1
+      ENDM
+
+; burst kernels: d6 = words - 1, d0/d1 = ciapra with REQ=0/REQ=1.
+; each word costs four CIA accesses. on a 68000 the dbra adds another
+; 10 cycles per word, so with HWF_UNROLL two words share one dbra.
+; 68020+ keep the compact loop: it sits in the i-cache and the CIA
+; accesses are the limit there anyway (see doc/src/amiga.md).
+
+SENDWORD MACRO
+      move.b   (a3)+,(a4)                          ; write even byte
+      move.b   d1,(a5)                             ; set REQ=1
+      move.b   (a3)+,(a4)                          ; write odd byte
+      move.b   d0,(a5)                             ; set REQ=0
+      ENDM
+
+RECVWORD MACRO
+      move.b   d0,(a5)                             ; set REQ=0
+      move.b   (a4),(a3)+                          ; read even byte
+      move.b   d1,(a5)                             ; set REQ=1
+      move.b   (a4),(a3)+                          ; read odd byte
+      ENDM
+
+; \1 = SENDWORD/RECVWORD, \2 = label prefix
+BURSTLOOP MACRO
+      btst     #HWB_UNROLL,hwb_Flags(a2)
+      beq.s    \2_Loop
+      lsr.w    #1,d6                               ; d6 = word pairs - 1
+      bcs.s    \2_Pairs                            ; even number of words
+      \1                                           ; odd word first
+      subq.w   #1,d6
+      bmi.s    \2_Done
+\2_Pairs:
+      \1
+      \1
+      dbra     d6,\2_Pairs
+      bra.s    \2_Done
+\2_Loop:
+      \1
+      dbra     d6,\2_Loop
+\2_Done:
+      ENDM
+
 
 ;----------------------------------------------------------------------------
 ;
@@ -101,9 +155,8 @@ hww_WaitRak1:
          btst     d4,d0
          beq.s    hww_RakOk1
          ; check for timeout
-         tst.b    hwb_TimeoutSet(a2)
-         beq.s    hww_WaitRak1
-         bra.s    hww_ExitError
+         CHKTIMEOUT hww_WaitRak1
+         bra      hww_ExitError
 hww_RakOk1:         
          ; --- init handshake 
          ; [OUT]
@@ -133,9 +186,8 @@ hww_WaitRak2a:
          btst     d4,d0                               ; RAK toggled?
          bne.s    hww_RakOk2a
          ; check for timeout
-         tst.b    hwb_TimeoutSet(a2)
-         beq.s    hww_WaitRak2a
-         bra.s    hww_ExitError
+         CHKTIMEOUT hww_WaitRak2a
+         bra      hww_ExitError
 hww_RakOk2a:
          ; Set <Size|Data_n>
          move.b   (a3)+,ciaa+ciaprb-BaseAX(a5)        ; write data to port
@@ -149,9 +201,8 @@ hww_WaitRak2b:
          btst     d4,d0                               ; RAK toggled?
          beq.s    hww_RakOk2b
          ; check for timeout
-         tst.b    hwb_TimeoutSet(a2)
-         beq.s    hww_WaitRak2b
-         bra.s    hww_ExitError
+         CHKTIMEOUT hww_WaitRak2b
+         bra      hww_ExitError
 hww_RakOk2b:
          ; Set <Size|Data_n>
          move.b   (a3)+,ciaa+ciaprb-BaseAX(a5)        ; write data to port
@@ -168,9 +219,8 @@ hww_WaitRak3:
          btst     d4,d0                               ; RAK toggled?
          bne.s    hww_RakOk3
          ; check for timeout
-         tst.b    hwb_TimeoutSet(a2)
-         beq.s    hww_WaitRak3
-         bra.s    hww_ExitError
+         CHKTIMEOUT hww_WaitRak3
+         bra      hww_ExitError
 hww_RakOk3:
         
          ; --- send is OK ---
@@ -216,8 +266,7 @@ hwr_WaitRak1:
          btst     d4,d0
          beq.s    hwr_RakOk1
          ; check for timeout
-         tst.b    hwb_TimeoutSet(a2)
-         beq.s    hwr_WaitRak1
+         CHKTIMEOUT hwr_WaitRak1
          bra      hwr_ExitError
 hwr_RakOk1:
    
@@ -237,9 +286,8 @@ hwr_WaitRak2:
          btst     d4,d0
          bne.s    hwr_RakOk2
          ; check for timeout
-         tst.b    hwb_TimeoutSet(a2)
-         beq.s    hwr_WaitRak2
-         bra.s    hwr_ExitError
+         CHKTIMEOUT hwr_WaitRak2
+         bra      hwr_ExitError
 hwr_RakOk2:
 
          ; [IN]
@@ -255,9 +303,8 @@ hwr_WaitRak3:
          btst     d4,d0                               ; RAK toggled?
          beq.s    hwr_RakOk3
          ; check for timeout
-         tst.b    hwb_TimeoutSet(a2)
-         beq.s    hwr_WaitRak3
-         bra.s    hwr_ExitError
+         CHKTIMEOUT hwr_WaitRak3
+         bra      hwr_ExitError
 hwr_RakOk3:
          
          ; Read <Size_Hi>
@@ -271,9 +318,8 @@ hwr_WaitRak4:
          btst     d4,d0
          bne.s    hwr_RakOk4
          ; check for timeout
-         tst.b    hwb_TimeoutSet(a2)
-         beq.s    hwr_WaitRak4
-         bra.s    hwr_ExitError
+         CHKTIMEOUT hwr_WaitRak4
+         bra      hwr_ExitError
 hwr_RakOk4:
          ; Read <Size_Lo>
          move.b   ciaa+ciaprb-BaseAX(a5),(a3)+        ; READCIABYTE
@@ -284,9 +330,9 @@ hwr_RakOk4:
          ; now fetch full size word and check for max frame size
          move.w   -2(a3),d6                           ; = length
          tst.w    d6
-         beq.s    hwr_ExitOk                          ; empty size? ok
+         beq      hwr_ExitOk                          ; empty size? ok
          cmp.w    hwb_MaxFrameSize(a2),d6             ; buffer too large
-         bhi.s    hwr_ExitError
+         bhi      hwr_ExitError
 
          ; convert to words
          ; (-1 for dbra)
@@ -306,9 +352,8 @@ hwr_WaitRak5a:
          btst     d4,d0                               ; RAK toggled?
          beq.s    hwr_RakOk5a
          ; check for timeout
-         tst.b    hwb_TimeoutSet(a2)
-         beq.s    hwr_WaitRak5a
-         bra.s    hwr_ExitError
+         CHKTIMEOUT hwr_WaitRak5a
+         bra      hwr_ExitError
 hwr_RakOk5a: 
          ; Read <DATA_n>
          move.b   ciaa+ciaprb-BaseAX(a5),(a3)+        ; read par port byte
@@ -321,9 +366,8 @@ hwr_WaitRak5b:
          btst     d4,d0                               ; RAK toggled?
          bne.s    hwr_RakOk5b
          ; check for timeout
-         tst.b    hwb_TimeoutSet(a2)
-         beq.s    hwr_WaitRak5b
-         bra.s    hwr_ExitError
+         CHKTIMEOUT hwr_WaitRak5b
+         bra      hwr_ExitError
 hwr_RakOk5b: 
          ; Read <DATA_n>
          move.b   ciaa+ciaprb-BaseAX(a5),(a3)+        ; read par port byte
@@ -394,16 +438,20 @@ bww_WaitRak1:
          btst     d4,d0
          beq.s    bww_RakOk1
          ; check for timeout
-         tst.b    hwb_TimeoutSet(a2)
-         beq.s    bww_WaitRak1
+         CHKTIMEOUT bww_WaitRak1
          bra      bww_ExitError
 bww_RakOk1:         
          ; --- init handshake 
          ; [OUT]
          SETCIAOUTPUT a5
          
-         ; Set <CMD_SEND_BURST>
-         move.b   #HWF_CMD_SEND_BURST,(a4)
+         ; Set <CMD_SEND_BURST> or <CMD_SEND_BURST_CRC>
+         moveq    #HWF_CMD_SEND_BURST,d0
+         btst     #HWB_BURST_CRC,hwb_Flags(a2)
+         beq.s    bww_CmdOk
+         move.b   #HWF_CMD_SEND_BURST_CRC,d0
+bww_CmdOk:
+         move.b   d0,(a4)
          
          ; Set SEL = 1 -> Trigger Plipbox
          SETSELECT a5
@@ -415,9 +463,8 @@ bww_WaitRak2a:
          btst     d4,d0                               ; RAK toggled?
          bne.s    bww_RakOk2a
          ; check for timeout
-         tst.b    hwb_TimeoutSet(a2)
-         beq.s    bww_WaitRak2a
-         bra.s    bww_ExitError
+         CHKTIMEOUT bww_WaitRak2a
+         bra      bww_ExitError
 bww_RakOk2a:
          ; Set <size> hi byte
          move.b   (a3)+,(a4)                          ; write data to port
@@ -430,15 +477,25 @@ bww_WaitRak2b:
          btst     d4,d0                               ; RAK toggled?
          beq.s    bww_RakOk2b
          ; check for timeout
-         tst.b    hwb_TimeoutSet(a2)
-         beq.s    bww_WaitRak2b
-         bra.s    bww_ExitError
+         CHKTIMEOUT bww_WaitRak2b
+         bra      bww_ExitError
 bww_RakOk2b:
          ; Set <size> lo byte
          move.b   (a3)+,(a4)                          ; write data to port
          ; Toggle REQ
          bclr     d3,(a5)                             ; set REQ=0
 
+         ; payload in the stack's buffer (SANA-II DMA)? then only the
+         ; header is taken from the frame and the frame holds the pointer
+         moveq    #-1,d5                              ; d5 = no payload
+         lsr.w    hwb_SendDma(a2)
+         bcc.s    bww_NoDma
+         move.l   HW_ETH_HDR_SIZE(a3),d7              ; d7 = payload
+         move.w   d6,d5
+         subq.w   #HW_ETH_HDR_SIZE/2,d5               ; d5 = its words - 1
+         moveq    #HW_ETH_HDR_SIZE/2-1,d6             ; d6 = header words - 1
+bww_NoDma:
+
          ; ---- burst enter sync
          ; Wait RAK == 1 (sync before burst)
 bww_WaitRak3a:
@@ -446,9 +503,8 @@ bww_WaitRak3a:
          btst     d4,d0                               ; RAK toggled?
          bne.s    bww_RakOk3a
          ; check for timeout
-         tst.b    hwb_TimeoutSet(a2)
-         beq.s    bww_WaitRak3a
-         bra.s    bww_ExitError
+         CHKTIMEOUT bww_WaitRak3a
+         bra      bww_ExitError
 bww_RakOk3a:
 
          ; disable all irq
@@ -462,22 +518,26 @@ bww_RakOk3a:
 
          ; --- burst loop begin
 bww_BurstLoop:
-         ; set even data 0,2,4,...
-         move.b   (a3)+,(a4)                          ; write data to port
-         ; Toggle REQ
-         move.b   d1,(a5)                             ; set REQ=1
-         
-         ; set odd data 1,3,5,...
-         move.b   (a3)+,(a4)                          ; write data to port
-         ; Toggle REQ
-         move.b   d0,(a5)                             ; set REQ=0
-
-         dbra     d6,bww_BurstLoop
+         BURSTLOOP SENDWORD,bww_Send
+
+         ; header done: continue with the payload
+         tst.w    d5
+         bmi.s    bww_BurstDone
+         move.w   d5,d6
+         moveq    #-1,d5
+         move.l   d7,a3
+         bra      bww_BurstLoop
+bww_BurstDone:
          ; --- burst loop end
 
          ; enable all irq
          JSRLIB   Enable
 
+         ; optional crc trailer: hi byte
+         btst     #HWB_BURST_CRC,hwb_Flags(a2)
+         beq.s    bww_NoCrcHi
+         move.b   hwb_BurstCrc(a2),(a4)               ; write data to port
+bww_NoCrcHi:
          bset     d3,(a5)                             ; set REQ=1
 
          ; ---- burst exit sync
@@ -487,11 +547,15 @@ bww_WaitRak3b:
          btst     d4,d0                               ; RAK toggled?
          beq.s    bww_RakOk3b
          ; check for timeout
-         tst.b    hwb_TimeoutSet(a2)
-         beq.s    bww_WaitRak3b
-         bra.s    bww_ExitError
+         CHKTIMEOUT bww_WaitRak3b
+         bra      bww_ExitError
 bww_RakOk3b:
 
+         ; optional crc trailer: lo byte
+         btst     #HWB_BURST_CRC,hwb_Flags(a2)
+         beq.s    bww_NoCrcLo
+         move.b   hwb_BurstCrc+1(a2),(a4)             ; write data to port
+bww_NoCrcLo:
          bclr     d3,(a5)                             ; set REQ=0
 
          ; --- wait final RAK
@@ -501,9 +565,8 @@ bww_WaitRak4:
          btst     d4,d0                               ; RAK toggled?
          bne.s    bww_ExitOk
          ; check for timeout
-         tst.b    hwb_TimeoutSet(a2)
-         beq.s    bww_WaitRak4
-         bra.s    bww_ExitError
+         CHKTIMEOUT bww_WaitRak4
+         bra      bww_ExitError
 
          ; --- exit
 bww_ExitOk:       
@@ -554,16 +617,20 @@ bwr_WaitRak1:
          btst     d4,d0
          beq.s    bwr_RakOk1
          ; check for timeout
-         tst.b    hwb_TimeoutSet(a2)
-         beq.s    bwr_WaitRak1
+         CHKTIMEOUT bwr_WaitRak1
          bra      bwr_ExitError
 bwr_RakOk1:         
          ; --- init handshake 
          ; [OUT]
          SETCIAOUTPUT a5
          
-         ; Set <CMD_RECV_BURST>
-         move.b   #HWF_CMD_RECV_BURST,(a4)
+         ; Set <CMD_RECV_BURST> or <CMD_RECV_BURST_CRC>
+         moveq    #HWF_CMD_RECV_BURST,d0
+         btst     #HWB_BURST_CRC,hwb_Flags(a2)
+         beq.s    bwr_CmdOk
+         move.b   #HWF_CMD_RECV_BURST_CRC,d0
+bwr_CmdOk:
+         move.b   d0,(a4)
          
          ; Set SEL = 1 -> Trigger Plipbox
          SETSELECT a5
@@ -575,8 +642,7 @@ bwr_WaitRak2a:
          btst     d4,d0                               ; RAK toggled?
          bne.s    bwr_RakOk2a
          ; check for timeout
-         tst.b    hwb_TimeoutSet(a2)
-         beq.s    bwr_WaitRak2a
+         CHKTIMEOUT bwr_WaitRak2a
          bra      bwr_ExitError
 bwr_RakOk2a:
          ; [IN]
@@ -591,9 +657,8 @@ bwr_WaitRak2b:
          btst     d4,d0                               ; RAK toggled?
          beq.s    bwr_RakOk2b
          ; check for timeout
-         tst.b    hwb_TimeoutSet(a2)
-         beq.s    bwr_WaitRak2b
-         bra.s    bwr_ExitError
+         CHKTIMEOUT bwr_WaitRak2b
+         bra      bwr_ExitError
 bwr_RakOk2b:
          
          ; Read <Size_Hi>
@@ -607,9 +672,8 @@ bwr_WaitRak2c:
          btst     d4,d0
          bne.s    bwr_RakOk2c
          ; check for timeout
-         tst.b    hwb_TimeoutSet(a2)
-         beq.s    bwr_WaitRak2c
-         bra.s    bwr_ExitError
+         CHKTIMEOUT bwr_WaitRak2c
+         bra      bwr_ExitError
 bwr_RakOk2c:
          ; Read <Size_Lo>
          move.b   (a4),(a3)+                          ; READCIABYTE
@@ -620,9 +684,9 @@ bwr_RakOk2c:
          ; now fetch full size word and check for max frame size
          move.w   -2(a3),d6                           ; = length
          tst.w    d6
-         beq.s    bwr_ExitOk                          ; empty size? ok
+         beq      bwr_ExitOk                          ; empty size? ok
          cmp.w    hwb_MaxFrameSize(a2),d6             ; buffer too large
-         bhi.s    bwr_ExitError
+         bhi      bwr_ExitError
 
          ; convert packet size (d6) to words-1 (and round up if necessary)
          subq.w   #1,d6
@@ -635,9 +699,8 @@ bwr_WaitRak3a:
          btst     d4,d0                               ; RAK toggled?
          beq.s    bwr_RakOk3a
          ; check for timeout
-         tst.b    hwb_TimeoutSet(a2)
-         beq.s    bwr_WaitRak3a
-         bra.s    bwr_ExitError
+         CHKTIMEOUT bwr_WaitRak3a
+         bra      bwr_ExitError
 bwr_RakOk3a:
 
          ; disable all irq
@@ -650,18 +713,7 @@ bwr_RakOk3a:
          bset     d3,d1                               ; set REQ=1
 
          ; --- burst loop begin
-bwr_BurstLoop:
-         ; Toggle REQ
-         move.b   d0,(a5)                             ; set REQ=0
-         ; get even data 0,2,4,...
-         move.b   (a4),(a3)+                          ; read data from port
-         
-         ; Toggle REQ
-         move.b   d1,(a5)                             ; set REQ=1
-         ; get odd data 1,3,5,...
-         move.b   (a4),(a3)+                          ; read data from port
-
-         dbra     d6,bwr_BurstLoop
+         BURSTLOOP RECVWORD,bwr_Recv
          ; --- burst loop end
 
          ; enable all irq
@@ -676,11 +728,13 @@ bwr_WaitRak3b:
          btst     d4,d0                               ; RAK toggled?
          bne.s    bwr_RakOk3b
          ; check for timeout
-         tst.b    hwb_TimeoutSet(a2)
-         beq.s    bwr_WaitRak3b
-         bra.s    bwr_ExitError
+         CHKTIMEOUT bwr_WaitRak3b
+         bra      bwr_ExitError
 bwr_RakOk3b:
 
+         ; optional crc trailer: hi byte
+         move.b   (a4),hwb_BurstCrc(a2)               ; read par port
+
          bset     d3,(a5)                             ; set REQ=1
 
          ; --- wait final RAK
@@ -688,11 +742,13 @@ bwr_RakOk3b:
 bwr_WaitRak4:
          move.b   (a5),d0                             ; ciab+ciapra
          btst     d4,d0                               ; RAK toggled?
-         beq.s    bwr_ExitOk
+         beq.s    bwr_RakOk4
          ; check for timeout
-         tst.b    hwb_TimeoutSet(a2)
-         beq.s    bwr_WaitRak4
-         bra.s    bwr_ExitError
+         CHKTIMEOUT bwr_WaitRak4
+         bra      bwr_ExitError
+bwr_RakOk4:
+         ; optional crc trailer: lo byte
+         move.b   (a4),hwb_BurstCrc+1(a2)             ; read par port
 
          ; --- exit
 bwr_ExitOk:       
@@ -717,4 +773,803 @@ bwr_ExitError:
          movem.l  (sp)+,d2-d7/a2-a6
          rts
 
+;----------------------------------------------------------------------------
+;
+; NAME
+;     hwstrobesend() - low level send routine in strobe mode
+;
+; SYNOPSIS
+;     void hwstrobesend(struct HWBase *, struct HWFrame *)
+;                       A0               A1
+;
+; FUNCTION
+;     Like hwburstsend() but the data bytes are clocked by the /STROBE
+;     pulse the CIA generates on each port B access. No REQ toggles are
+;     needed in the data loop.
+_hwstrobesend:
+         movem.l  d2-d7/a2-a6,-(sp)
+         move.l   a0,a2                               ; a2 = HWBase
+         move.l   a1,a3                               ; a3 = Frame
+         move.l   hwb_SysBase(a2),a6                  ; a6 = SysBase
+         moveq    #FALSE,d2                           ; d2 = return value
+         moveq    #HS_REQ_BIT,d3                      ; d3 = HS_REQ
+         moveq    #HS_RAK_BIT,d4                      ; d4 = HS_RAK
+         lea      BaseAX,a5                           ; a5 = CIA HW base
+
+         ; a4 = data reg of CIA
+         move.l   a5,a4
+         add.l    #(ciaa+ciaprb-BaseAX),a4
+
+         ; --- size calc for burst
+         ; packet size (in bytes) rounded to words (d6)
+         move.w   (a3),d6
+         subq.w   #1,d6
+         lsr.w    #1,d6                               ; d6 = packet size in words - 1
+
+         ; --- prepare
+         ; Wait RAK == 0
+ssw_WaitRak1:
+         move.b   (a5),d0                             ; ciab+ciapra
+         btst     d4,d0
+         beq.s    ssw_RakOk1
+         ; check for timeout
+         CHKTIMEOUT ssw_WaitRak1
+         bra      ssw_ExitError
+ssw_RakOk1:         
+         ; --- init handshake 
+         ; [OUT]
+         SETCIAOUTPUT a5
+         
+         ; Set <CMD_SEND_STROBE>
+         move.b   #HWF_CMD_SEND_STROBE,(a4)
+         
+         ; Set SEL = 1 -> Trigger Plipbox
+         SETSELECT a5
+
+         ; --- send size (without burst)
+         ; Wait RAK == 1
+ssw_WaitRak2a:
+         move.b   (a5),d0                             ; ciab+ciapra
+         btst     d4,d0                               ; RAK toggled?
+         bne.s    ssw_RakOk2a
+         ; check for timeout
+         CHKTIMEOUT ssw_WaitRak2a
+         bra      ssw_ExitError
+ssw_RakOk2a:
+         ; Set <size> hi byte
+         move.b   (a3)+,(a4)                          ; write data to port
+         ; Toggle REQ
+         bset     d3,(a5)                             ; set REQ=1
+
+         ; Wait RAK == 0
+ssw_WaitRak2b:
+         move.b   (a5),d0                             ; ciab+ciapra
+         btst     d4,d0                               ; RAK toggled?
+         beq.s    ssw_RakOk2b
+         ; check for timeout
+         CHKTIMEOUT ssw_WaitRak2b
+         bra      ssw_ExitError
+ssw_RakOk2b:
+         ; Set <size> lo byte
+         move.b   (a3)+,(a4)                          ; write data to port
+         ; Toggle REQ
+         bclr     d3,(a5)                             ; set REQ=0
+
+         ; ---- burst enter sync
+         ; Wait RAK == 1 (sync before burst)
+ssw_WaitRak3a:
+         move.b   (a5),d0                             ; ciab+ciapra
+         btst     d4,d0                               ; RAK toggled?
+         bne.s    ssw_RakOk3a
+         ; check for timeout
+         CHKTIMEOUT ssw_WaitRak3a
+         bra      ssw_ExitError
+ssw_RakOk3a:
+
+         ; disable all irq
+         JSRLIB   Disable
+         
+         ; --- strobe loop begin
+ssw_StrobeLoop:
+         ; set even data 0,2,4,... -> CIA pulses /STROBE
+         move.b   (a3)+,(a4)                          ; write data to port
+         ; set odd data 1,3,5,... -> CIA pulses /STROBE
+         move.b   (a3)+,(a4)                          ; write data to port
+         dbra     d6,ssw_StrobeLoop
+         ; --- strobe loop end
+
+         ; enable all irq
+         JSRLIB   Enable
+
+         bset     d3,(a5)                             ; set REQ=1
+
+         ; ---- burst exit sync
+         ; Wait RAK == 0 (sync after burst)
+ssw_WaitRak3b:
+         move.b   (a5),d0                             ; ciab+ciapra
+         btst     d4,d0                               ; RAK toggled?
+         beq.s    ssw_RakOk3b
+         ; check for timeout
+         CHKTIMEOUT ssw_WaitRak3b
+         bra      ssw_ExitError
+ssw_RakOk3b:
+
+         bclr     d3,(a5)                             ; set REQ=0
+
+         ; --- wait final RAK
+         ; final Wait RAK == 1
+ssw_WaitRak4:
+         move.b   (a5),d0                             ; ciab+ciapra
+         btst     d4,d0                               ; RAK toggled?
+         bne.s    ssw_ExitOk
+         ; check for timeout
+         CHKTIMEOUT ssw_WaitRak4
+         bra      ssw_ExitError
+
+         ; --- exit
+ssw_ExitOk:       
+         moveq    #TRUE,d2                            ; rc = TRUE
+ssw_ExitError:
+
+         ; [IN]
+         SETCIAINPUT a5
+
+         ; SEL = 0
+         CLRSELECT a5
+
+         move.l   d2,d0                               ; return rc
+         movem.l  (sp)+,d2-d7/a2-a6
+         rts
+
+;----------------------------------------------------------------------------
+;
+; NAME
+;     hwstroberecv() - low level receive routine in strobe mode
+;
+; SYNOPSIS
+;     void hwstroberecv(struct HWBase *, struct HWFrame *)
+;                       A0               A1
+;
+; FUNCTION
+;     Like hwburstrecv() but plipbox puts the next byte on the port
+;     when it sees the /STROBE pulse of the last read. No REQ toggles are
+;     needed in the data loop.
+_hwstroberecv:
+         movem.l  d2-d7/a2-a6,-(sp)
+         move.l   a0,a2                               ; a2 = HWBase
+         move.l   a1,a3                               ; a3 = Frame
+         move.l   hwb_SysBase(a2),a6                  ; a6 = SysBase
+         moveq    #FALSE,d2                           ; d2 = return value
+         moveq    #HS_REQ_BIT,d3                      ; d3 = HS_REQ
+         moveq    #HS_RAK_BIT,d4                      ; d4 = HS_RAK
+         lea      BaseAX,a5                           ; a5 = CIA HW base
+
+         ; a4 = data reg of CIA
+         move.l   a5,a4
+         add.l    #(ciaa+ciaprb-BaseAX),a4
+
+         ; --- prepare
+         ; Wait RAK == 0
+ssr_WaitRak1:
+         move.b   (a5),d0                             ; ciab+ciapra
+         btst     d4,d0
+         beq.s    ssr_RakOk1
+         ; check for timeout
+         CHKTIMEOUT ssr_WaitRak1
+         bra      ssr_ExitError
+ssr_RakOk1:         
+         ; --- init handshake 
+         ; [OUT]
+         SETCIAOUTPUT a5
+         
+         ; Set <CMD_RECV_STROBE>
+         move.b   #HWF_CMD_RECV_STROBE,(a4)
+         
+         ; Set SEL = 1 -> Trigger Plipbox
+         SETSELECT a5
+
+         ; --- toggle to input
+         ; Wait RAK == 1
+ssr_WaitRak2a:
+         move.b   (a5),d0                             ; ciab+ciapra
+         btst     d4,d0                               ; RAK toggled?
+         bne.s    ssr_RakOk2a
+         ; check for timeout
+         CHKTIMEOUT ssr_WaitRak2a
+         bra      ssr_ExitError
+ssr_RakOk2a:
+         ; [IN]
+         SETCIAINPUT a5
+         ; Toggle REQ
+         bset     d3,(a5)                             ; set REQ=1
+
+         ; --- read size word ---
+         ; Wait RAK == 0
+ssr_WaitRak2b:
+         move.b   (a5),d0                             ; ciab+ciapra
+         btst     d4,d0                               ; RAK toggled?
+         beq.s    ssr_RakOk2b
+         ; check for timeout
+         CHKTIMEOUT ssr_WaitRak2b
+         bra      ssr_ExitError
+ssr_RakOk2b:
+         
+         ; Read <Size_Hi>
+         move.b   (a4),(a3)+                          ; read par port
+         ; Set REQ = 0
+         bclr     d3,(a5)                             ; REQ toggle
+         
+         ; Wait RAK == 1
+ssr_WaitRak2c:
+         move.b   (a5),d0                             ; ciab+ciapra
+         btst     d4,d0
+         bne.s    ssr_RakOk2c
+         ; check for timeout
+         CHKTIMEOUT ssr_WaitRak2c
+         bra      ssr_ExitError
+ssr_RakOk2c:
+         ; Read <Size_Lo>
+         move.b   (a4),(a3)+                          ; READCIABYTE
+         ; Set REQ = 1
+         bset     d3,(a5)                             ; REQ toggle
+
+         ; --- check size
+         ; now fetch full size word and check for max frame size
+         move.w   -2(a3),d6                           ; = length
+         tst.w    d6
+         beq      ssr_ExitOk                          ; empty size? ok
+         cmp.w    hwb_MaxFrameSize(a2),d6             ; buffer too large
+         bhi      ssr_ExitError
+
+         ; convert packet size (d6) to words-1 (and round up if necessary)
+         subq.w   #1,d6
+         lsr.w    #1,d6
+
+         ; ---- burst enter
+         ; Wait RAK == 0 (sync before burst)
+ssr_WaitRak3a:
+         move.b   (a5),d0                             ; ciab+ciapra
+         btst     d4,d0                               ; RAK toggled?
+         beq.s    ssr_RakOk3a
+         ; check for timeout
+         CHKTIMEOUT ssr_WaitRak3a
+         bra      ssr_ExitError
+ssr_RakOk3a:
+
+         ; disable all irq
+         JSRLIB   Disable
+                  
+         ; --- strobe loop begin
+ssr_StrobeLoop:
+         ; get even data 0,2,4,... -> CIA pulses /STROBE
+         move.b   (a4),(a3)+                          ; read data from port
+         ; get odd data 1,3,5,... -> CIA pulses /STROBE
+         move.b   (a4),(a3)+                          ; read data from port
+         dbra     d6,ssr_StrobeLoop
+         ; --- strobe loop end
+
+         ; enable all irq
+         JSRLIB   Enable
+
+         bclr     d3,(a5)                             ; set REQ=0
+
+         ; ---- burst leave
+         ; Wait RAK == 1 (sync after burst)
+ssr_WaitRak3b:
+         move.b   (a5),d0                             ; ciab+ciapra
+         btst     d4,d0                               ; RAK toggled?
+         bne.s    ssr_RakOk3b
+         ; check for timeout
+         CHKTIMEOUT ssr_WaitRak3b
+         bra      ssr_ExitError
+ssr_RakOk3b:
+
+         bset     d3,(a5)                             ; set REQ=1
+
+         ; --- wait final RAK
+         ; final Wait RAK == 0
+ssr_WaitRak4:
+         move.b   (a5),d0                             ; ciab+ciapra
+         btst     d4,d0                               ; RAK toggled?
+         beq.s    ssr_ExitOk
+         ; check for timeout
+         CHKTIMEOUT ssr_WaitRak4
+         bra      ssr_ExitError
+
+         ; --- exit
+ssr_ExitOk:       
+         moveq    #TRUE,d2                            ; rc = TRUE
+ssr_ExitError:
+
+         ; reset signal
+         moveq    #0,d0
+         move.l   hwb_IntSigMask(a2),d1
+         JSRLIB   SetSignal
+         
+         ; clear RECV_PENDING flag set by irq
+         bclr     #HWB_RECV_PENDING,hwb_Flags(a2)
+
+         ; clear REQ
+         bclr     d3,(a5)
+
+         ; SEL = 0
+         CLRSELECT a5
+
+         move.l   d2,d0                               ; return rc
+         movem.l  (sp)+,d2-d7/a2-a6
+         rts
+
+;----------------------------------------------------------------------------
+;
+; NAME
+;     hwburstsendmulti() - send several frames in burst mode
+;
+; SYNOPSIS
+;     void hwburstsendmulti(struct HWBase *, struct HWFrame *)
+;                           A0               A1
+;
+; FUNCTION
+;     Send a list of frames stored back to back (word aligned) in a single
+;     selection. Each frame is transferred like in hwburstsend(). After
+;     the final RAK of a frame the size of the next one follows. The
+;     terminating frame of size 0 is sent as well and ends the transfer.
+_hwburstsendmulti:
+         movem.l  d2-d7/a2-a6,-(sp)
+         move.l   a0,a2                               ; a2 = HWBase
+         move.l   a1,a3                               ; a3 = Frame
+         move.l   hwb_SysBase(a2),a6                  ; a6 = SysBase
+         moveq    #FALSE,d2                           ; d2 = return value
+         moveq    #HS_REQ_BIT,d3                      ; d3 = HS_REQ
+         moveq    #HS_RAK_BIT,d4                      ; d4 = HS_RAK
+         lea      BaseAX,a5                           ; a5 = CIA HW base
+
+         ; a4 = data reg of CIA
+         move.l   a5,a4
+         add.l    #(ciaa+ciaprb-BaseAX),a4
+
+         ; --- prepare
+         ; Wait RAK == 0
+bms_WaitRak1:
+         move.b   (a5),d0                             ; ciab+ciapra
+         btst     d4,d0
+         beq.s    bms_RakOk1
+         ; check for timeout
+         CHKTIMEOUT bms_WaitRak1
+         bra      bms_ExitError
+bms_RakOk1:         
+         ; --- init handshake 
+         ; [OUT]
+         SETCIAOUTPUT a5
+         
+         ; Set <CMD_SEND_MULTI>
+         move.b   #HWF_CMD_SEND_MULTI,(a4)
+         
+         ; Set SEL = 1 -> Trigger Plipbox
+         SETSELECT a5
+
+         ; --- next frame
+bms_NextFrame:
+         ; packet size (in bytes)
+         move.w   (a3),d6
+         moveq    #0,d7                               ; d7 = no next frame
+
+         ; --- send size (without burst)
+         ; Wait RAK == 1
+bms_WaitRak2a:
+         move.b   (a5),d0                             ; ciab+ciapra
+         btst     d4,d0                               ; RAK toggled?
+         bne.s    bms_RakOk2a
+         ; check for timeout
+         CHKTIMEOUT bms_WaitRak2a
+         bra      bms_ExitError
+bms_RakOk2a:
+         ; Set <size> hi byte
+         move.b   (a3)+,(a4)                          ; write data to port
+         ; Toggle REQ
+         bset     d3,(a5)                             ; set REQ=1
+
+         ; Wait RAK == 0
+bms_WaitRak2b:
+         move.b   (a5),d0                             ; ciab+ciapra
+         btst     d4,d0                               ; RAK toggled?
+         beq.s    bms_RakOk2b
+         ; check for timeout
+         CHKTIMEOUT bms_WaitRak2b
+         bra      bms_ExitError
+bms_RakOk2b:
+         ; Set <size> lo byte
+         move.b   (a3)+,(a4)                          ; write data to port
+         ; Toggle REQ
+         bclr     d3,(a5)                             ; set REQ=0
+
+         ; empty frame: wait for RAK == 1 and leave
+         tst.w    d6
+         beq      bms_WaitRak4
+
+         ; convert to words - 1
+         subq.w   #1,d6
+         lsr.w    #1,d6
+
+         ; payload in the stack's buffer (SANA-II DMA)? see hwburstsend()
+         moveq    #-1,d5                              ; d5 = no payload
+         lsr.w    hwb_SendDma(a2)
+         bcc.s    bms_NoDma
+         move.l   HW_ETH_HDR_SIZE(a3),d7              ; d7 = payload
+         move.w   d6,d5
+         subq.w   #HW_ETH_HDR_SIZE/2,d5               ; d5 = its words - 1
+         moveq    #HW_ETH_HDR_SIZE/2-1,d6             ; d6 = header words - 1
+bms_NoDma:
+
+         ; ---- burst enter sync
+         ; Wait RAK == 1 (sync before burst)
+bms_WaitRak3a:
+         move.b   (a5),d0                             ; ciab+ciapra
+         btst     d4,d0                               ; RAK toggled?
+         bne.s    bms_RakOk3a
+         ; check for timeout
+         CHKTIMEOUT bms_WaitRak3a
+         bra      bms_ExitError
+bms_RakOk3a:
+
+         ; disable all irq
+         JSRLIB   Disable
+         
+         ; use d0 and d1 temporarily to optimize loop
+         move.b   (a5),d0
+         move.b   d0,d1
+         bclr     d3,d0                               ; set REQ=0
+         bset     d3,d1                               ; set REQ=1
+
+         ; --- burst loop begin
+bms_BurstLoop:
+         BURSTLOOP SENDWORD,bms_Send
+
+         ; header done: continue with the payload. the frame still has
+         ; room for it, so d7 = its end = next frame
+         tst.w    d5
+         bmi.s    bms_BurstDone
+         move.w   d5,d6
+         exg      d7,a3
+         ext.l    d5
+         addq.l   #1,d5
+         add.l    d5,d7
+         add.l    d5,d7
+         moveq    #-1,d5
+         bra      bms_BurstLoop
+bms_BurstDone:
+         ; --- burst loop end
+
+         ; enable all irq
+         JSRLIB   Enable
+
+         bset     d3,(a5)                             ; set REQ=1
+
+         ; ---- burst exit sync
+         ; Wait RAK == 0 (sync after burst)
+bms_WaitRak3b:
+         move.b   (a5),d0                             ; ciab+ciapra
+         btst     d4,d0                               ; RAK toggled?
+         beq.s    bms_RakOk3b
+         ; check for timeout
+         CHKTIMEOUT bms_WaitRak3b
+         bra      bms_ExitError
+bms_RakOk3b:
+
+         bclr     d3,(a5)                             ; set REQ=0
+
+         ; --- wait final RAK
+         ; final Wait RAK == 1
+bms_WaitRak4:
+         move.b   (a5),d0                             ; ciab+ciapra
+         btst     d4,d0                               ; RAK toggled?
+         bne.s    bms_RakOk4
+         ; check for timeout
+         CHKTIMEOUT bms_WaitRak4
+         bra      bms_ExitError
+bms_RakOk4:
+         ; skip the payload area of a DMA frame
+         tst.l    d7
+         beq.s    bms_NoSkip
+         move.l   d7,a3
+bms_NoSkip:
+         ; more frames?
+         tst.w    d6
+         bne      bms_NextFrame
+
+         ; --- exit
+         moveq    #TRUE,d2                            ; rc = TRUE
+bms_ExitError:
+
+         ; [IN]
+         SETCIAINPUT a5
+
+         ; SEL = 0
+         CLRSELECT a5
+
+         move.l   d2,d0                               ; return rc
+         movem.l  (sp)+,d2-d7/a2-a6
+         rts
+
+;----------------------------------------------------------------------------
+;
+; NAME
+;     hwburstrecvmulti() - receive several frames in burst mode
+;
+; SYNOPSIS
+;     void hwburstrecvmulti(struct HWBase *, struct HWFrame *)
+;                           A0               A1
+;
+; FUNCTION
+;     Receive up to HW_MULTI_MAX frames in a single selection. Each frame
+;     is transferred like in hwburstrecv() but the final RAK of a frame
+;     already announces the size of the next one. A frame of size 0 ends
+;     the transfer. The frames are stored back to back (word aligned) and
+;     the final size 0 terminates the list.
+_hwburstrecvmulti:
+         movem.l  d2-d7/a2-a6,-(sp)
+         move.l   a0,a2                               ; a2 = HWBase
+         move.l   a1,a3                               ; a3 = Frame
+         move.l   hwb_SysBase(a2),a6                  ; a6 = SysBase
+         moveq    #HW_MULTI_MAX,d5                    ; d5 = frames left
+         moveq    #FALSE,d2                           ; d2 = return value
+         moveq    #HS_REQ_BIT,d3                      ; d3 = HS_REQ
+         moveq    #HS_RAK_BIT,d4                      ; d4 = HS_RAK
+         lea      BaseAX,a5                           ; a5 = CIA HW base
+
+         ; a4 = data reg of CIA
+         move.l   a5,a4
+         add.l    #(ciaa+ciaprb-BaseAX),a4
+
+         ; --- prepare
+         ; Wait RAK == 0
+bmr_WaitRak1:
+         move.b   (a5),d0                             ; ciab+ciapra
+         btst     d4,d0
+         beq.s    bmr_RakOk1
+         ; check for timeout
+         CHKTIMEOUT bmr_WaitRak1
+         bra      bmr_ExitError
+bmr_RakOk1:         
+         ; --- init handshake 
+         ; [OUT]
+         SETCIAOUTPUT a5
+         
+         ; Set <CMD_RECV_MULTI>
+         move.b   #HWF_CMD_RECV_MULTI,(a4)
+         
+         ; Set SEL = 1 -> Trigger Plipbox
+         SETSELECT a5
+
+         ; --- toggle to input
+         ; Wait RAK == 1
+bmr_WaitRak2a:
+         move.b   (a5),d0                             ; ciab+ciapra
+         btst     d4,d0                               ; RAK toggled?
+         bne.s    bmr_RakOk2a
+         ; check for timeout
+         CHKTIMEOUT bmr_WaitRak2a
+         bra      bmr_ExitError
+bmr_RakOk2a:
+         ; [IN]
+         SETCIAINPUT a5
+         ; Toggle REQ
+         bset     d3,(a5)                             ; set REQ=1
+
+         ; --- next frame: read size word ---
+bmr_NextFrame:
+         ; Wait RAK == 0
+bmr_WaitRak2b:
+         move.b   (a5),d0                             ; ciab+ciapra
+         btst     d4,d0                               ; RAK toggled?
+         beq.s    bmr_RakOk2b
+         ; check for timeout
+         CHKTIMEOUT bmr_WaitRak2b
+         bra      bmr_ExitError
+bmr_RakOk2b:
+         
+         ; Read <Size_Hi>
+         move.b   (a4),(a3)+                          ; read par port
+         ; Set REQ = 0
+         bclr     d3,(a5)                             ; REQ toggle
+         
+         ; Wait RAK == 1
+bmr_WaitRak2c:
+         move.b   (a5),d0                             ; ciab+ciapra
+         btst     d4,d0
+         bne.s    bmr_RakOk2c
+         ; check for timeout
+         CHKTIMEOUT bmr_WaitRak2c
+         bra      bmr_ExitError
+bmr_RakOk2c:
+         ; Read <Size_Lo>
+         move.b   (a4),(a3)+                          ; READCIABYTE
+         ; Set REQ = 1
+         bset     d3,(a5)                             ; REQ toggle
+
+         ; --- check size
+         ; now fetch full size word and check for max frame size
+         move.w   -2(a3),d6                           ; = length
+         tst.w    d6
+         beq      bmr_ExitOk                          ; empty size? done
+         cmp.w    hwb_MaxFrameSize(a2),d6             ; buffer too large
+         bhi      bmr_ExitError
+         subq.w   #1,d5                               ; too many frames?
+         bmi      bmr_ExitError
+
+         ; convert packet size (d6) to words-1 (and round up if necessary)
+         subq.w   #1,d6
+         lsr.w    #1,d6
+
+         ; ---- burst enter
+         ; Wait RAK == 0 (sync before burst)
+bmr_WaitRak3a:
+         move.b   (a5),d0                             ; ciab+ciapra
+         btst     d4,d0                               ; RAK toggled?
+         beq.s    bmr_RakOk3a
+         ; check for timeout
+         CHKTIMEOUT bmr_WaitRak3a
+         bra      bmr_ExitError
+bmr_RakOk3a:
+
+         ; disable all irq
+         JSRLIB   Disable
+                  
+         ; use d0 and d1 temporarily to optimize loop
+         move.b   (a5),d0
+         move.b   d0,d1
+         bclr     d3,d0                               ; set REQ=0
+         bset     d3,d1                               ; set REQ=1
+
+         ; --- burst loop begin
+         BURSTLOOP RECVWORD,bmr_Recv
+         ; --- burst loop end
+
+         ; enable all irq
+         JSRLIB   Enable
+
+         bclr     d3,(a5)                             ; set REQ=0
+
+         ; ---- burst leave
+         ; Wait RAK == 1 (sync after burst)
+bmr_WaitRak3b:
+         move.b   (a5),d0                             ; ciab+ciapra
+         btst     d4,d0                               ; RAK toggled?
+         bne.s    bmr_RakOk3b
+         ; check for timeout
+         CHKTIMEOUT bmr_WaitRak3b
+         bra      bmr_ExitError
+bmr_RakOk3b:
+
+         bset     d3,(a5)                             ; set REQ=1
+
+         ; final RAK == 0 comes with size of next frame
+         bra      bmr_NextFrame
+
+         ; --- exit
+bmr_ExitOk:       
+         moveq    #TRUE,d2                            ; rc = TRUE
+bmr_ExitError:
+
+         ; reset signal
+         moveq    #0,d0
+         move.l   hwb_IntSigMask(a2),d1
+         JSRLIB   SetSignal
+         
+         ; clear RECV_PENDING flag set by irq
+         bclr     #HWB_RECV_PENDING,hwb_Flags(a2)
+
+         ; clear REQ
+         bclr     d3,(a5)
+
+         ; SEL = 0
+         CLRSELECT a5
+
+         move.l   d2,d0                               ; return rc
+         movem.l  (sp)+,d2-d7/a2-a6
+         rts
+
+;----------------------------------------------------------------------------
+;
+; NAME
+;     chkdeadline - check the transfer timeout against the E clock
+;
+; SYNOPSIS
+;     bsr chkdeadline with A2 = HWBase
+;
+; FUNCTION
+;     Called by CHKTIMEOUT once the poll budget is used up. The first
+;     call of a transfer starts the deadline, later ones compare the low
+;     E clock longword with it. Sets hwb_TimeoutSet and returns Z=1 while
+;     the deadline has not passed. All registers are kept.
+chkdeadline:
+         movem.l  d0-d1/a0-a1/a6,-(sp)
+         move.w   #HW_POLL_COUNT,hwb_PollCount(a2)    ; next poll budget
+         subq.l   #8,sp                               ; struct EClockVal
+         move.l   sp,a0
+         move.l   hwb_TimerBase(a2),a6
+         JSRLIB   ReadEClock
+         move.l   4(sp),d0                            ; d0 = ev_lo = now
+         addq.l   #8,sp
+         tst.w    hwb_DeadlineSet(a2)
+         bne.s    cd_Check
+         ; first check: timeout runs from now
+         add.l    hwb_TimeoutTicks(a2),d0
+         move.l   d0,hwb_Deadline(a2)
+         move.w   #1,hwb_DeadlineSet(a2)
+         moveq    #0,d0                               ; Z=1: go on
+         bra.s    cd_Done
+cd_Check:
+         sub.l    hwb_Deadline(a2),d0                 ; now - deadline
+         spl      d0                                  ; >= 0: timed out
+         move.b   d0,hwb_TimeoutSet(a2)               ; Z=1: go on
+cd_Done:
+         movem.l  (sp)+,d0-d1/a0-a1/a6               ; keeps ccr
+         rts
+
+;----------------------------------------------------------------------------
+;
+; NAME
+;     CRC16() - calculate CRC-CCITT of a buffer
+;
+; SYNOPSIS
+;     USHORT CRC16(UBYTE *, SHORT)
+;                  A0       D0
+;
+; FUNCTION
+;     Table driven CRC-CCITT (reflected, init $ffff) as built by the
+;     plipbox firmware for the burst crc trailer.
+_CRC16:
+         move.l   d2,-(sp)
+         lea      crc_Table(pc),a1
+         move.w   d0,d1                               ; d1 = length
+         moveq    #-1,d0                              ; d0 = crc
+         bra.s    crc_Next
+crc_Loop:
+         moveq    #0,d2
+         move.b   (a0)+,d2
+         eor.b    d0,d2                               ; index = (crc ^ data)
+         add.w    d2,d2
+         lsr.w    #8,d0
+         move.w   0(a1,d2.w),d2
+         eor.w    d2,d0                               ; crc = (crc >> 8) ^ tab
+crc_Next:
+         dbra     d1,crc_Loop
+         and.l    #$ffff,d0                           ; return crc
+         move.l   (sp)+,d2
+         rts
+
+crc_Table:
+         dc.w     $0000,$1189,$2312,$329b,$4624,$57ad,$6536,$74bf
+         dc.w     $8c48,$9dc1,$af5a,$bed3,$ca6c,$dbe5,$e97e,$f8f7
+         dc.w     $1081,$0108,$3393,$221a,$56a5,$472c,$75b7,$643e
+         dc.w     $9cc9,$8d40,$bfdb,$ae52,$daed,$cb64,$f9ff,$e876
+         dc.w     $2102,$308b,$0210,$1399,$6726,$76af,$4434,$55bd
+         dc.w     $ad4a,$bcc3,$8e58,$9fd1,$eb6e,$fae7,$c87c,$d9f5
+         dc.w     $3183,$200a,$1291,$0318,$77a7,$662e,$54b5,$453c
+         dc.w     $bdcb,$ac42,$9ed9,$8f50,$fbef,$ea66,$d8fd,$c974
+         dc.w     $4204,$538d,$6116,$709f,$0420,$15a9,$2732,$36bb
+         dc.w     $ce4c,$dfc5,$ed5e,$fcd7,$8868,$99e1,$ab7a,$baf3
+         dc.w     $5285,$430c,$7197,$601e,$14a1,$0528,$37b3,$263a
+         dc.w     $decd,$cf44,$fddf,$ec56,$98e9,$8960,$bbfb,$aa72
+         dc.w     $6306,$728f,$4014,$519d,$2522,$34ab,$0630,$17b9
+         dc.w     $ef4e,$fec7,$cc5c,$ddd5,$a96a,$b8e3,$8a78,$9bf1
+         dc.w     $7387,$620e,$5095,$411c,$35a3,$242a,$16b1,$0738
+         dc.w     $ffcf,$ee46,$dcdd,$cd54,$b9eb,$a862,$9af9,$8b70
+         dc.w     $8408,$9581,$a71a,$b693,$c22c,$d3a5,$e13e,$f0b7
+         dc.w     $0840,$19c9,$2b52,$3adb,$4e64,$5fed,$6d76,$7cff
+         dc.w     $9489,$8500,$b79b,$a612,$d2ad,$c324,$f1bf,$e036
+         dc.w     $18c1,$0948,$3bd3,$2a5a,$5ee5,$4f6c,$7df7,$6c7e
+         dc.w     $a50a,$b483,$8618,$9791,$e32e,$f2a7,$c03c,$d1b5
+         dc.w     $2942,$38cb,$0a50,$1bd9,$6f66,$7eef,$4c74,$5dfd
+         dc.w     $b58b,$a402,$9699,$8710,$f3af,$e226,$d0bd,$c134
+         dc.w     $39c3,$284a,$1ad1,$0b58,$7fe7,$6e6e,$5cf5,$4d7c
+         dc.w     $c60c,$d785,$e51e,$f497,$8028,$91a1,$a33a,$b2b3
+         dc.w     $4a44,$5bcd,$6956,$78df,$0c60,$1de9,$2f72,$3efb
+         dc.w     $d68d,$c704,$f59f,$e416,$90a9,$8120,$b3bb,$a232
+         dc.w     $5ac5,$4b4c,$79d7,$685e,$1ce1,$0d68,$3ff3,$2e7a
+         dc.w     $e70e,$f687,$c41c,$d595,$a12a,$b0a3,$8238,$93b1
+         dc.w     $6b46,$7acf,$4854,$59dd,$2d62,$3ceb,$0e70,$1ff9
+         dc.w     $f78f,$e606,$d49d,$c514,$b1ab,$a022,$92b9,$8330
+         dc.w     $7bc7,$6a4e,$58d5,$495c,$3de3,$2c6a,$1ef1,$0f78
+
          end
@@ -31,6 +31,16 @@ HWF_CMD_SEND     equ     $11
 HWF_CMD_RECV     equ     $22
 HWF_CMD_SEND_BURST equ   $33
 HWF_CMD_RECV_BURST equ   $44
+HWF_CMD_RECV_MULTI equ   $55
+HWF_CMD_SEND_MULTI equ   $66
+HWF_CMD_SEND_STROBE equ  $77
+HWF_CMD_RECV_STROBE equ  $88
+HWF_CMD_SEND_BURST_CRC equ $99
+HWF_CMD_RECV_BURST_CRC equ $aa
+
+HW_MULTI_MAX     equ     4
+HW_ETH_HDR_SIZE  equ     14
+HW_POLL_COUNT    equ     32
 
 PKTFRAMESIZE_1   equ     4
 PKTFRAMESIZE_2   equ     2
@@ -56,9 +66,18 @@ SYNCWORD_NOCRC   equ     ((SYNCBYTE_HEAD<<8)|SYNCBYTE_NOCRC)
      UWORD  hwb_MaxFrameSize
      UBYTE  hwb_TimeoutSet
      UBYTE  hwb_Flags
+     UWORD  hwb_BurstCrc
+     UWORD  hwb_SendDma
+     APTR   hwb_TimerBase
+     ULONG  hwb_TimeoutTicks
+     ULONG  hwb_Deadline
+     UWORD  hwb_PollCount
+     UWORD  hwb_DeadlineSet
    LABEL HWBase_SIZE
 
    BITDEF HW,RECV_PENDING,0
+   BITDEF HW,BURST_CRC,2
+   BITDEF HW,UNROLL,3
 
    ;
    ; Why isn't this in exec/types.i ?
@@ -46,12 +46,15 @@
    /*
    ** return codes for write_frame()
    */
-typedef enum { AW_OK, AW_BUFFER_ERROR, AW_ERROR } AW_RESULT;
+typedef enum { AW_OK, AW_BUFFER_ERROR, AW_ERROR, AW_DMA } AW_RESULT;
 
 /*E*/
 /*F*/ /* imports */
    /* external functions */
 GLOBAL VOID dotracktype(BASEPTR, ULONG type, ULONG ps, ULONG pr, ULONG bs, ULONG br, ULONG pd);
+GLOBAL VOID initfiltertypes(BASEPTR);
+GLOBAL BOOL ismcastaddr(BASEPTR, UBYTE *addr);
+GLOBAL UWORD getmcastaddrs(BASEPTR, UBYTE *addrs, UWORD max);
 GLOBAL VOID DevTermIO(BASEPTR, struct IOSana2Req *ios2);
 /*E*/
 /*F*/ /* exports */
@@ -64,8 +67,12 @@ PRIVATE VOID readargs(BASEPTR);
 PRIVATE BOOL init(BASEPTR);
 PRIVATE REGARGS BOOL goonline(BASEPTR);
 PRIVATE REGARGS VOID gooffline(BASEPTR);
-PRIVATE REGARGS AW_RESULT write_frame(BASEPTR, struct IOSana2Req *ios2);
+PRIVATE REGARGS VOID dofilter(BASEPTR);
+PRIVATE REGARGS VOID domcast(BASEPTR);
+PRIVATE REGARGS AW_RESULT write_frame(BASEPTR, struct IOSana2Req *ios2, struct HWFrame *frame, BOOL dma);
+PRIVATE REGARGS VOID write_done(BASEPTR, struct IOSana2Req *currentwrite, struct HWFrame *frame, AW_RESULT code);
 PRIVATE REGARGS VOID dowritereqs(BASEPTR);
+PRIVATE REGARGS VOID dispatchframe(BASEPTR, struct HWFrame *frame);
 PRIVATE REGARGS VOID doreadreqs(BASEPTR);
 PRIVATE REGARGS VOID dos2reqs(BASEPTR);
 /*E*/
@@ -76,6 +83,7 @@ PRIVATE REGARGS VOID dos2reqs(BASEPTR);
 /*F*/ PRIVATE REGARGS VOID rejectpackets(BASEPTR)
 {
    struct IOSana2Req *ios2;
+   UWORD i;
 
    ObtainSemaphore(&pb->pb_WriteListSem);
    while(ios2 = (struct IOSana2Req *)RemHead((struct List*)&pb->pb_WriteList))
@@ -87,11 +95,14 @@ PRIVATE REGARGS VOID dos2reqs(BASEPTR);
    ReleaseSemaphore(&pb->pb_WriteListSem);
 
    ObtainSemaphore(&pb->pb_ReadListSem);
-   while(ios2 = (struct IOSana2Req *)RemHead((struct List*)&pb->pb_ReadList))
+   for(i = 0; i < PLIP_READ_BUCKETS; i++)
    {
-      ios2->ios2_Req.io_Error = S2ERR_OUTOFSERVICE;
-      ios2->ios2_WireError = S2WERR_UNIT_OFFLINE;
-      DevTermIO(pb,ios2);
+      while(ios2 = (struct IOSana2Req *)RemHead((struct List*)&pb->pb_ReadList[i]))
+      {
+         ios2->ios2_Req.io_Error = S2ERR_OUTOFSERVICE;
+         ios2->ios2_WireError = S2WERR_UNIT_OFFLINE;
+         DevTermIO(pb,ios2);
+      }
    }
    ReleaseSemaphore(&pb->pb_ReadListSem);
 
@@ -125,6 +136,8 @@ PRIVATE REGARGS VOID dos2reqs(BASEPTR);
          
          /* send magic */
          hw_send_magic_pkt(pb, HW_MAGIC_ONLINE);
+         /* filter is sent once plipbox agreed on it */
+         initfiltertypes(pb);
 
          GetSysTime(&pb->pb_DevStats.LastStart);
          pb->pb_Flags &= ~PLIPF_OFFLINE;
@@ -150,6 +163,47 @@ PRIVATE REGARGS VOID dos2reqs(BASEPTR);
    }
    d(("ok!\n"));
 }
+/*E*/
+
+/*F*/ PRIVATE REGARGS VOID dofilter(BASEPTR)
+{
+   struct HWBase *hwb = &pb->pb_HWBase;
+   UWORD types[HW_FILTER_MAX];
+   UWORD num;
+
+   Forbid();
+   pb->pb_Flags &= ~PLIPF_FILTER;
+   num = pb->pb_FilterNum;
+   CopyMem(pb->pb_FilterTypes, types, sizeof(types));
+   Permit();
+
+   /* older firmware would pass the magic on to the LAN */
+   if ((pb->pb_Flags & PLIPF_OFFLINE) || !(hwb->hwb_Caps & HW_CAP_FILTER) || (num == 0))
+      return;
+
+   if (num == PLIP_FILTER_ALL)
+      num = 0;
+   d(("filter: %ld types\n", (ULONG)num));
+   hw_send_filter_pkt(pb, types, num);
+}
+/*E*/
+/*F*/ PRIVATE REGARGS VOID domcast(BASEPTR)
+{
+   struct HWBase *hwb = &pb->pb_HWBase;
+   UBYTE addrs[HW_MCAST_MAX * HW_ADDRFIELDSIZE];
+   UWORD num;
+
+   Forbid();
+   pb->pb_Flags &= ~PLIPF_MCAST;
+   Permit();
+
+   if ((pb->pb_Flags & PLIPF_OFFLINE) || !(hwb->hwb_Caps & HW_CAP_MCAST))
+      return;
+
+   num = getmcastaddrs(pb, addrs, HW_MCAST_MAX);
+   d(("mcast: %ld groups\n", (ULONG)num));
+   hw_send_mcast_pkt(pb, addrs, num);
+}
 /*E*/
 
    /*
@@ -181,12 +235,12 @@ PRIVATE REGARGS VOID dos2reqs(BASEPTR);
    /*
    ** writing packets
    */
-/*F*/ PRIVATE REGARGS AW_RESULT write_frame(BASEPTR, struct IOSana2Req *ios2)
+/*F*/ PRIVATE REGARGS AW_RESULT write_frame(BASEPTR, struct IOSana2Req *ios2, struct HWFrame *frame, BOOL dma)
 {
    AW_RESULT rc;
-   struct HWFrame *frame = pb->pb_Frame;
    struct BufferManagement *bm;
    UBYTE *frame_ptr;
+   ULONG *data;
    
    d(("write: type %08lx, size %ld\n",ios2->ios2_PacketType,
                                       ios2->ios2_DataLength));
@@ -205,6 +259,21 @@ PRIVATE REGARGS VOID dos2reqs(BASEPTR);
 
    bm = (struct BufferManagement *)ios2->ios2_BufferManagement;
 
+   /* let the hw send the payload right from the stack's buffer:
+      the frame only keeps a pointer to it. the pointer sits where the
+      payload would be, so a shorter payload is copied: the next frame
+      would start inside the pointer */
+   if (dma && bm->bm_DMACopyFromBuffer &&
+       ios2->ios2_DataLength >= sizeof(APTR) &&
+       !(ios2->ios2_Req.io_Flags & SANA2IOF_RAW))
+   {
+      if (data = (*bm->bm_DMACopyFromBuffer)(ios2->ios2_Data))
+      {
+         *(ULONG **)frame_ptr = data;
+         return AW_DMA;
+      }
+   }
+
    if (!(*bm->bm_CopyFromBuffer)(frame_ptr,
                                ios2->ios2_Data, ios2->ios2_DataLength))
    {
@@ -212,27 +281,64 @@ PRIVATE REGARGS VOID dos2reqs(BASEPTR);
    }
    else
    {
-      d8(("+hw_send\n"));
-      rc = hw_send_frame(pb, frame) ? AW_OK : AW_ERROR;
-      d8(("-hw_send\n"));
-#if DEBUG&8
-      if(rc==AW_ERROR) d8(("Error sending packet (size=%ld)\n", (LONG)pb->pb_Frame->hwf_Size));
-#endif
+      rc = AW_OK;
    }
 
    return rc;
 }
 /*E*/
+/*F*/ PRIVATE REGARGS VOID write_done(BASEPTR, struct IOSana2Req *currentwrite, struct HWFrame *frame, AW_RESULT code)
+{
+   if (code == AW_BUFFER_ERROR)  /* BufferManagement callback error */
+   {
+      d(("buffer error\n"));
+      DoEvent(pb, S2EVENT_ERROR | S2EVENT_BUFF | S2EVENT_SOFTWARE);
+      pb->pb_SpecialStats[S2SS_TXERRORS].Count++;
+      d(("pb->pb_SpecialStats[S2SS_TXERRORS].Count = %ld\n",pb->pb_SpecialStats[S2SS_TXERRORS].Count));
+      currentwrite->ios2_Req.io_Error = S2ERR_SOFTWARE;
+      currentwrite->ios2_WireError = S2WERR_BUFF_ERROR;
+   }
+   else if (code == AW_ERROR)
+   {
+      /*
+      ** this is a real line error, upper levels (e.g. Internet TCP) have
+      ** to care for reliability!
+      */
+      d(("error while transmitting packet\n"));
+      DoEvent(pb, S2EVENT_ERROR | S2EVENT_TX | S2EVENT_HARDWARE);
+      pb->pb_SpecialStats[S2SS_TXERRORS].Count++;
+      d(("pb->pb_SpecialStats[S2SS_TXERRORS].Count = %ld\n",pb->pb_SpecialStats[S2SS_TXERRORS].Count));
+      currentwrite->ios2_Req.io_Error = S2ERR_TX_FAILURE;
+      currentwrite->ios2_WireError = S2WERR_GENERIC_ERROR;
+   }
+   else /*if (code == AW_OK)*/                             /* well done! */
+   {
+      d(("packet transmitted successfully\n"));
+      pb->pb_DevStats.PacketsSent++;
+      dotracktype(pb, (ULONG) frame->hwf_Type, 1, 0, currentwrite->ios2_DataLength, 0, 0);
+      currentwrite->ios2_Req.io_Error = S2ERR_NO_ERROR;
+      currentwrite->ios2_WireError = S2WERR_GENERIC_ERROR;
+   }
+   Remove((struct Node*)currentwrite);
+   DevTermIO(pb, currentwrite);
+}
+/*E*/
 /*F*/ PRIVATE REGARGS VOID dowritereqs(BASEPTR)
 {
    struct IOSana2Req *currentwrite, *nextwrite;
+   struct IOSana2Req *batch[HW_MULTI_MAX];
+   struct HWFrame *frames[HW_MULTI_MAX];
+   struct HWFrame *frame;
+   UWORD max_frames, num, i, dma;
    AW_RESULT code;
+   BOOL rc, ok, use_dma;
 
    ObtainSemaphore(&pb->pb_WriteListSem);
 
-   for(currentwrite = (struct IOSana2Req *)pb->pb_WriteList.lh_Head;
-       nextwrite = (struct IOSana2Req *) currentwrite->ios2_Req.io_Message.mn_Node.ln_Succ;
-       currentwrite = nextwrite )
+   max_frames = hw_send_max_frames(pb);
+   use_dma = hw_send_dma(pb);
+   currentwrite = (struct IOSana2Req *)pb->pb_WriteList.lh_Head;
+   while(currentwrite->ios2_Req.io_Message.mn_Node.ln_Succ)
    {
       if (hw_recv_pending(pb))
       {
@@ -240,43 +346,51 @@ PRIVATE REGARGS VOID dos2reqs(BASEPTR);
          break;
       }
 
-      code = write_frame(pb, currentwrite);
-
-      if (code == AW_BUFFER_ERROR)  /* BufferManagement callback error */
+      /* pack as many pending writes as the plipbox takes in one transfer */
+      frame = pb->pb_Frame;
+      num = 0;
+      dma = 0;
+      while((num < max_frames) &&
+            (nextwrite = (struct IOSana2Req *)currentwrite->ios2_Req.io_Message.mn_Node.ln_Succ))
       {
-         d(("buffer error\n"));
-         DoEvent(pb, S2EVENT_ERROR | S2EVENT_BUFF | S2EVENT_SOFTWARE);
-         pb->pb_SpecialStats[S2SS_TXERRORS].Count++;
-         d(("pb->pb_SpecialStats[S2SS_TXERRORS].Count = %ld\n",pb->pb_SpecialStats[S2SS_TXERRORS].Count));
-         currentwrite->ios2_Req.io_Error = S2ERR_SOFTWARE;
-         currentwrite->ios2_WireError = S2WERR_BUFF_ERROR;
-         Remove((struct Node*)currentwrite);
-         DevTermIO(pb, currentwrite);
+         code = write_frame(pb, currentwrite, frame, use_dma);
+         if ((code == AW_OK) || (code == AW_DMA))
+         {
+            if (code == AW_DMA)
+            {
+               dma |= 1 << num;
+            }
+            batch[num] = currentwrite;
+            frames[num] = frame;
+            num++;
+            frame = HW_NEXT_FRAME(frame);
+         }
+         else
+         {
+            write_done(pb, currentwrite, frame, code);
+         }
+         currentwrite = nextwrite;
       }
-      else if (code == AW_ERROR)
+      if (num == 0)
       {
-         /*
-         ** this is a real line error, upper levels (e.g. Internet TCP) have
-         ** to care for reliability!
-         */
-         d(("error while transmitting packet\n"));
-         DoEvent(pb, S2EVENT_ERROR | S2EVENT_TX | S2EVENT_HARDWARE);
-         pb->pb_SpecialStats[S2SS_TXERRORS].Count++;
-         d(("pb->pb_SpecialStats[S2SS_TXERRORS].Count = %ld\n",pb->pb_SpecialStats[S2SS_TXERRORS].Count));
-         currentwrite->ios2_Req.io_Error = S2ERR_TX_FAILURE;
-         currentwrite->ios2_WireError = S2WERR_GENERIC_ERROR;
-         Remove((struct Node*)currentwrite);
-         DevTermIO(pb, currentwrite);
+         continue;
       }
-      else /*if (code == AW_OK)*/                             /* well done! */
+
+      /* terminate frame list and send it */
+      frame->hwf_Size = 0;
+      d8(("+hw_send\n"));
+      rc = hw_send_frames(pb, pb->pb_Frame, dma);
+      d8(("-hw_send\n"));
+#if DEBUG&8
+      if(!rc) d8(("Error sending %ld packets\n", (LONG)num));
+#endif
+
+      for(i=0;i<num;i++)
       {
-         d(("packet transmitted successfully\n"));
-         pb->pb_DevStats.PacketsSent++;
-         dotracktype(pb, (ULONG) pb->pb_Frame->hwf_Type, 1, 0, currentwrite->ios2_DataLength, 0, 0);
-         currentwrite->ios2_Req.io_Error = S2ERR_NO_ERROR;
-         currentwrite->ios2_WireError = S2WERR_GENERIC_ERROR;
-         Remove((struct Node*)currentwrite);
-         DevTermIO(pb, currentwrite);
+         /* a failed multi transfer: retry each frame on its own so one
+            broken frame does not fail the whole batch */
+         ok = rc || ((num > 1) && hw_send_single(pb, frames[i], (dma >> i) & 1));
+         write_done(pb, batch[i], frames[i], ok ? AW_OK : AW_ERROR);
       }
    }
 
@@ -291,6 +405,7 @@ PRIVATE REGARGS BOOL read_frame(struct IOSana2Req *req, struct HWFrame *frame)
    LONG datasize;
    BYTE *frame_ptr;
    struct BufferManagement *bm;
+   ULONG *dst;
    BOOL ok;
    
    /* deliver a raw frame: copy data right into ethernet header */
@@ -307,9 +422,16 @@ PRIVATE REGARGS BOOL read_frame(struct IOSana2Req *req, struct HWFrame *frame)
 
    req->ios2_DataLength = datasize;
    
-   /* copy packet buffer */
+   /* copy packet buffer: directly if the stack tells us where to */
    bm = (struct BufferManagement *)req->ios2_BufferManagement;
-   if (!(*bm->bm_CopyToBuffer)(req->ios2_Data, frame_ptr, datasize))
+   if (bm->bm_DMACopyToBuffer &&
+       (dst = (*bm->bm_DMACopyToBuffer)(req->ios2_Data)))
+   {
+      CopyMem(frame_ptr, dst, datasize);
+      req->ios2_Req.io_Error = req->ios2_WireError = 0;
+      ok = TRUE;
+   }
+   else if (!(*bm->bm_CopyToBuffer)(req->ios2_Data, frame_ptr, datasize))
    {
       d(("CopyToBuffer: error\n"));
       req->ios2_Req.io_Error = S2ERR_SOFTWARE;
@@ -337,6 +459,9 @@ PRIVATE REGARGS BOOL read_frame(struct IOSana2Req *req, struct HWFrame *frame)
    if(broadcast) {
       req->ios2_Req.io_Flags |= SANA2IOF_BCAST;
    }
+   else if(frame->hwf_DstAddr[0] & 1) {
+      req->ios2_Req.io_Flags |= SANA2IOF_MCAST;
+   }
    
    /* store packet type */
    req->ios2_PacketType = (USHORT)frame->hwf_Type;
@@ -347,81 +472,99 @@ PRIVATE REGARGS BOOL read_frame(struct IOSana2Req *req, struct HWFrame *frame)
    /*
    ** reading packets
    */
-/*F*/ PRIVATE REGARGS VOID doreadreqs(BASEPTR)
+/*F*/ PRIVATE REGARGS VOID dispatchframe(BASEPTR, struct HWFrame *frame)
 {
    LONG datasize;
    struct IOSana2Req *got;
    ULONG pkttyp;
-   BOOL rv;
-   struct HWFrame *frame = pb->pb_Frame;
 
-   d8(("+hw_recv\n"));
-   rv = hw_recv_frame(pb, frame);
-   d8(("-hw_recv\n"));
-   if (rv)
-   {
-      pb->pb_DevStats.PacketsReceived++;
+   /* plipbox sends an empty frame if it had to drop a broken one */
+   if(frame->hwf_Size < HW_ETH_HDR_SIZE) {
+      d(("empty frame\n"));
+      return;
+   }
 
-      pkttyp = frame->hwf_Type;
+   pb->pb_DevStats.PacketsReceived++;
 
-      /* perform internal loop back of magic packets of type 0xfffd */
-      if(pkttyp == HW_MAGIC_LOOPBACK) {
-         d(("loop back packet (size %ld)\n",frame->hwf_Size));
-         hw_send_frame(pb, frame);
-         return;
-      }
+   pkttyp = frame->hwf_Type;
 
-      /* plipbox requests online magic (again) */
-      if(pkttyp == HW_MAGIC_ONLINE) {
-         d(("request online magic"));
-         hw_send_magic_pkt(pb, HW_MAGIC_ONLINE);
-         return;
-      }
+   /* perform internal loop back of magic packets of type 0xfffd */
+   if(pkttyp == HW_MAGIC_LOOPBACK) {
+      d(("loop back packet (size %ld)\n",frame->hwf_Size));
+      hw_send_frame(pb, frame);
+      return;
+   }
 
-      datasize = frame->hwf_Size - HW_ETH_HDR_SIZE;
+   /* echo burst delay calibration frames back to plipbox */
+   if(pkttyp == HW_MAGIC_CALIB) {
+      d(("calib packet (size %ld)\n",frame->hwf_Size));
+      hw_send_frame(pb, frame);
+      return;
+   }
 
-      dotracktype(pb, pkttyp, 0, 1, 0, datasize, 0);
+   /* plipbox requests online magic (again) */
+   if(pkttyp == HW_MAGIC_ONLINE) {
+      d(("request online magic"));
+      hw_send_magic_pkt(pb, HW_MAGIC_ONLINE);
+      return;
+   }
 
-      d(("packet %08lx, size %ld received\n",pkttyp,datasize));
+   /* plipbox replies the capabilities it agrees on */
+   if(pkttyp == HW_MAGIC_CAPS) {
+      hw_recv_caps_pkt(pb, frame);
+      pb->pb_Flags |= PLIPF_FILTER | PLIPF_MCAST;
+      return;
+   }
 
-      ObtainSemaphore(&pb->pb_ReadListSem);
+   /* the hash in plipbox also passes groups nobody joined (ff: broadcast) */
+   if((frame->hwf_DstAddr[0] & 1) && (frame->hwf_DstAddr[0] != 0xff) &&
+      !ismcastaddr(pb, frame->hwf_DstAddr)) {
+      d(("multicast not joined\n"));
+      return;
+   }
 
-         /* traverse the list of read-requests */
-      for(got = (struct IOSana2Req *)pb->pb_ReadList.lh_Head;
-          got->ios2_Req.io_Message.mn_Node.ln_Succ;
-          got = (struct IOSana2Req *)got->ios2_Req.io_Message.mn_Node.ln_Succ )
-      {
-            /* check if this one requests for the new packet we got */
-         if (got->ios2_PacketType == pkttyp )
-         {
-            BOOL ok;
-            
-            Remove((struct Node*)got);
+   /* HTEN also passes foreign unicasts; promiscuous opens are refused */
+   if(!(frame->hwf_DstAddr[0] & 1) &&
+      memcmp(frame->hwf_DstAddr, pb->pb_CfgAddr, HW_ADDRFIELDSIZE)) {
+      d(("unicast not for us\n"));
+      return;
+   }
 
-            /* deliver packet */
-            ok = read_frame(got, frame);
-            if(!ok) {
-               DoEvent(pb, S2EVENT_ERROR | S2EVENT_BUFF | S2EVENT_SOFTWARE);
-            }
+   datasize = frame->hwf_Size - HW_ETH_HDR_SIZE;
 
-            d(("packet received, satisfying S2Request\n"));
-            DevTermIO(pb, got);
-            got = NULL;
-            break;
-         }
-      }
+   dotracktype(pb, pkttyp, 0, 1, 0, datasize, 0);
 
-      ReleaseSemaphore(&pb->pb_ReadListSem);
-   }
-   else
+   d(("packet %08lx, size %ld received\n",pkttyp,datasize));
+
+   ObtainSemaphore(&pb->pb_ReadListSem);
+
+      /* traverse the read-requests of this type's bucket */
+   for(got = (struct IOSana2Req *)pb->pb_ReadList[PLIP_READ_BUCKET(pkttyp)].lh_Head;
+       got->ios2_Req.io_Message.mn_Node.ln_Succ;
+       got = (struct IOSana2Req *)got->ios2_Req.io_Message.mn_Node.ln_Succ )
    {
-      d8(("Error receiving (%ld. len=%ld)\n", rv, frame->hwf_Size));
-      /* something went wrong during receipt */
-      DoEvent(pb, S2EVENT_HARDWARE | S2EVENT_ERROR | S2EVENT_RX);
-      got = NULL;
-      pb->pb_DevStats.BadData++;
+         /* check if this one requests for the new packet we got */
+      if (got->ios2_PacketType == pkttyp )
+      {
+         BOOL ok;
+         
+         Remove((struct Node*)got);
+
+         /* deliver packet */
+         ok = read_frame(got, frame);
+         if(!ok) {
+            DoEvent(pb, S2EVENT_ERROR | S2EVENT_BUFF | S2EVENT_SOFTWARE);
+         }
+
+         d(("packet received, satisfying S2Request\n"));
+         DevTermIO(pb, got);
+         got = NULL;
+         break;
+      }
    }
 
+   ReleaseSemaphore(&pb->pb_ReadListSem);
+
       /* If no one wanted this packet explicitely, there is one chance
       ** left: somebody waiting for orphaned packets. If this fails, too,
       ** we will drop it.
@@ -454,6 +597,35 @@ PRIVATE REGARGS BOOL read_frame(struct IOSana2Req *req, struct HWFrame *frame)
       }
    }
 }
+/*E*/
+/*F*/ PRIVATE REGARGS VOID doreadreqs(BASEPTR)
+{
+   BOOL rv;
+   struct HWFrame *frame = pb->pb_Frame;
+   struct HWFrame *next;
+
+   d8(("+hw_recv\n"));
+   rv = hw_recv_frame(pb, frame);
+   d8(("-hw_recv\n"));
+   if (rv)
+   {
+      /* a multi transfer may have delivered several frames */
+      while(frame->hwf_Size != 0)
+      {
+         /* loop back and calib echoes are sent in place */
+         next = HW_NEXT_FRAME(frame);
+         dispatchframe(pb, frame);
+         frame = next;
+      }
+   }
+   else
+   {
+      d8(("Error receiving (%ld. len=%ld)\n", rv, frame->hwf_Size));
+      /* something went wrong during receipt */
+      DoEvent(pb, S2EVENT_HARDWARE | S2EVENT_ERROR | S2EVENT_RX);
+      pb->pb_DevStats.BadData++;
+   }
+}
 /*E*/
 
    /*
@@ -608,9 +780,10 @@ PRIVATE REGARGS BOOL read_frame(struct IOSana2Req *req, struct HWFrame *frame)
    {  
       /* init hardware */
       if(hw_init(pb)) {
-         ULONG size = (ULONG)sizeof(struct HWFrame) + pb->pb_MTU;
+         ULONG size = HW_FRAME_BUF_SIZE(pb->pb_MTU);
          d(("allocating 0x%lx/%ld bytes frame buffer\n",size,size));
-         if ((pb->pb_Frame = AllocVec(size, MEMF_CLEAR|MEMF_ANY)))
+         if ((pb->pb_Frame = AllocVec(size, MEMF_CLEAR|MEMF_ANY)) &&
+             (pb->pb_CtlFrame = AllocVec(HW_CTL_FRAME_SIZE, MEMF_CLEAR|MEMF_ANY)))
          {
             rc = TRUE;
          }
@@ -643,6 +816,7 @@ PRIVATE REGARGS BOOL read_frame(struct IOSana2Req *req, struct HWFrame *frame)
    while(bm = (struct BufferManagement *)RemHead((struct List *)&pb->pb_BufferManagement))
       FreeVec(bm);
 
+   if (pb->pb_CtlFrame) FreeVec(pb->pb_CtlFrame);
    if (pb->pb_Frame) FreeVec(pb->pb_Frame);
 
    hw_cleanup(pb);
@@ -716,6 +890,14 @@ PRIVATE REGARGS BOOL read_frame(struct IOSana2Req *req, struct HWFrame *frame)
             dowritereqs(pb);
             d2(("*- do_write\n"));
             
+            /* tell plipbox about new read types */
+            if (pb->pb_Flags & PLIPF_FILTER)
+               dofilter(pb);
+
+            /* and about joined or left multicast groups */
+            if (pb->pb_Flags & PLIPF_MCAST)
+               domcast(pb);
+
             /* handle SANA-II send requests */
             if (recv & portsigmask)
             {
@@ -32,21 +32,33 @@ PUBLIC BOOL addtracktype(BASEPTR, ULONG type);
 PUBLIC BOOL remtracktype(BASEPTR, ULONG type);
 PUBLIC VOID dotracktype(BASEPTR, ULONG type, ULONG ps, ULONG pr, ULONG bs, ULONG br, ULONG pd);
 PUBLIC BOOL gettrackrec(BASEPTR, ULONG type, APTR info);
-PUBLIC VOID freetracktypes(BASEPTR);
+PUBLIC VOID addfiltertype(BASEPTR, ULONG type);
+PUBLIC VOID initfiltertypes(BASEPTR);
 /*E*/
 /*F*/ /* private */
 PRIVATE struct TrackRec *findtracktype(BASEPTR, ULONG type);
+PRIVATE BOOL filtertype(BASEPTR, ULONG type);
 /*E*/
 
+   /*
+   ** all lookups and updates of the table run under Forbid(): a slot
+   ** can not be freed and reused between lookup and update, and the
+   ** stats are never copied out half updated. no semaphore needed.
+   */
 /*F*/ PRIVATE INLINE struct TrackRec *findtracktype(BASEPTR, ULONG type)
 {
-   struct TrackRec * tr;
+   struct TrackRec *tr;
+   UWORD i, n;
 
-   for (tr = (struct TrackRec *) pb->pb_TrackList.lh_Head; tr->tr_Link.mln_Succ;
-                                                      tr = (struct TrackRec *) tr->tr_Link.mln_Succ)
+   i = PLIP_TYPE_HASH(type, PLIP_TRACK_MAX);
+   for (n = 0; n < PLIP_TRACK_MAX; n++)
    {
-      if( tr->tr_PacketType == type )
+      tr = &pb->pb_TrackTab[i];
+      if (!tr->tr_Used)
+         break;
+      if (tr->tr_Count && (tr->tr_PacketType == type))
          return( tr );
+      i = (i + 1) & (PLIP_TRACK_MAX - 1);
    }
 
    return( NULL );
@@ -55,25 +67,37 @@ PRIVATE struct TrackRec *findtracktype(BASEPTR, ULONG type);
 /*F*/ PUBLIC BOOL addtracktype(BASEPTR, ULONG type)
 {
    struct TrackRec *tr;
+   UWORD i, n;
    BOOL rv = FALSE;
 
-   ObtainSemaphore(&pb->pb_TrackListSem);
-   if (!(tr = findtracktype(pb, type)))
+   Forbid();
+   if (tr = findtracktype(pb, type))
    {
-      if (tr = AllocVec(sizeof(*tr), MEMF_CLEAR))
-      {
-         tr->tr_Count = 1;
-         tr->tr_PacketType = type;
-         AddTail((struct List*)&pb->pb_TrackList, (struct Node *)tr);
-         rv = TRUE;
-      }
+      ++tr->tr_Count;
+      rv = TRUE;
    }
    else
    {
-      ++tr->tr_Count;
-      rv = TRUE;
+      /* first free slot of the probe sequence */
+      i = PLIP_TYPE_HASH(type, PLIP_TRACK_MAX);
+      for (n = 0; n < PLIP_TRACK_MAX; n++)
+      {
+         tr = &pb->pb_TrackTab[i];
+         if (!tr->tr_Count)
+         {
+            memset(&tr->tr_Sana2PacketTypeStats, 0,
+                   sizeof(tr->tr_Sana2PacketTypeStats));
+            tr->tr_PacketType = type;
+            tr->tr_Count = 1;
+            tr->tr_Used = 1;
+            pb->pb_TrackNum++;
+            rv = TRUE;
+            break;
+         }
+         i = (i + 1) & (PLIP_TRACK_MAX - 1);
+      }
    }
-   ReleaseSemaphore(&pb->pb_TrackListSem);
+   Permit();
 
    return rv;
 }
@@ -83,17 +107,18 @@ PRIVATE struct TrackRec *findtracktype(BASEPTR, ULONG type);
    struct TrackRec *tr;
    BOOL rv = FALSE;
 
-   ObtainSemaphore( &pb->pb_TrackListSem );
+   Forbid();
    if (tr = findtracktype(pb, type))
    {
+      /* tr_Used stays set: later types may have probed past it */
       if (!(--tr->tr_Count))
       {
-         Remove((struct Node *)tr);
-         FreeVec(tr);
+         if (!(--pb->pb_TrackNum))
+            memset(pb->pb_TrackTab, 0, sizeof(pb->pb_TrackTab));
       }
       rv = TRUE;
    }
-   ReleaseSemaphore( &pb->pb_TrackListSem );
+   Permit();
 
    return rv;
 }
@@ -102,7 +127,11 @@ PRIVATE struct TrackRec *findtracktype(BASEPTR, ULONG type);
 {
    struct TrackRec * tr;
 
-   ObtainSemaphore(&pb->pb_TrackListSem);
+   /* nobody tracks: nothing to look up */
+   if (!pb->pb_TrackNum)
+      return;
+
+   Forbid();
    if (tr = findtracktype(pb, type))
    {
       tr->tr_Sana2PacketTypeStats.PacketsSent += ps;
@@ -111,7 +140,7 @@ PRIVATE struct TrackRec *findtracktype(BASEPTR, ULONG type);
       tr->tr_Sana2PacketTypeStats.BytesReceived += br;
       tr->tr_Sana2PacketTypeStats.PacketsDropped += pd;
    }
-   ReleaseSemaphore(&pb->pb_TrackListSem);
+   Permit();
 }
 /*E*/
 /*F*/ PUBLIC BOOL gettrackrec(BASEPTR, ULONG type, struct Sana2PacketTypeStats *info)
@@ -119,25 +148,87 @@ PRIVATE struct TrackRec *findtracktype(BASEPTR, ULONG type);
    struct TrackRec * tr;
    BOOL rv = FALSE;
 
-   ObtainSemaphoreShared( &pb->pb_TrackListSem );
+   Forbid();
    if (tr = findtracktype(pb, type))
    {
       *info = tr->tr_Sana2PacketTypeStats;
       rv = TRUE;
    }
-   ReleaseSemaphore( &pb->pb_TrackListSem );
+   Permit();
 
    return rv;
 }
 /*E*/
-/*F*/ PUBLIC VOID freetracktypes(BASEPTR)
+
+
+   /*
+   ** the types read since going online. plipbox uses them to drop the
+   ** broadcasts nobody here reads. the set only grows while online as
+   ** the stacks re-queue their reads all the time.
+   */
+/*F*/ PRIVATE BOOL filtertype(BASEPTR, ULONG type)
 {
-   struct Node *tr;
+   UWORD i, num = pb->pb_FilterNum;
 
-   ObtainSemaphore(&pb->pb_TrackListSem);
-   while(tr = RemHead((struct List*)&pb->pb_TrackList))
-      FreeVec(tr);
-   ReleaseSemaphore(&pb->pb_TrackListSem);
+   if (num == PLIP_FILTER_ALL)
+      return FALSE;
+
+   for (i = 0; i < num; i++)
+   {
+      if (pb->pb_FilterTypes[i] == type)
+         return FALSE;
+   }
+
+   /* orphans, 802.3 lengths and too many types: pass all */
+   if ((type > 0xffff) || (type <= HW_ETH_MTU) || (num == HW_FILTER_MAX))
+      pb->pb_FilterNum = PLIP_FILTER_ALL;
+   else
+   {
+      pb->pb_FilterTypes[num] = type;
+      pb->pb_FilterNum = num + 1;
+   }
+   pb->pb_Flags |= PLIPF_FILTER;
+   return TRUE;
+}
+/*E*/
+/*F*/ PUBLIC VOID addfiltertype(BASEPTR, ULONG type)
+{
+   Forbid();
+   if (filtertype(pb, type))
+      Signal((struct Task*)pb->pb_Server, SIGBREAKF_CTRL_F);
+   Permit();
+}
+/*E*/
+/*F*/ PUBLIC VOID initfiltertypes(BASEPTR)
+{
+   struct IOSana2Req *ios2;
+   struct TrackRec *tr;
+   UWORD i;
+
+   Forbid();
+   pb->pb_FilterNum = 0;
+   pb->pb_Flags &= ~PLIPF_FILTER;
+   Permit();
+
+   /* readers still queued from the last session */
+   ObtainSemaphore(&pb->pb_ReadListSem);
+   for (i = 0; i < PLIP_READ_BUCKETS; i++)
+      for (ios2 = (struct IOSana2Req *)pb->pb_ReadList[i].lh_Head;
+           ios2->ios2_Req.io_Message.mn_Node.ln_Succ;
+           ios2 = (struct IOSana2Req *)ios2->ios2_Req.io_Message.mn_Node.ln_Succ)
+         addfiltertype(pb, ios2->ios2_PacketType);
+   ReleaseSemaphore(&pb->pb_ReadListSem);
+
+   ObtainSemaphoreShared(&pb->pb_ReadOrphanListSem);
+   if (pb->pb_ReadOrphanList.lh_Head->ln_Succ)
+      addfiltertype(pb, ~0);
+   ReleaseSemaphore(&pb->pb_ReadOrphanListSem);
+
+   for (i = 0; i < PLIP_TRACK_MAX; i++)
+   {
+      tr = &pb->pb_TrackTab[i];
+      if (tr->tr_Count)
+         addfiltertype(pb, tr->tr_PacketType);
+   }
 }
 /*E*/
-
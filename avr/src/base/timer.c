@@ -120,13 +120,13 @@ void timer_delay_100us(u16 timeout)
 
 // hw timer
 
-u16 timer_hw_calc_rate_kbs(u16 bytes, u16 delta)
+u32 timer_hw_calc_rate_kbs(u16 bytes, u16 delta)
 {
   if(delta != 0) {
     u32 nom = 1000 * (u32)bytes * 100;
     u32 denom = (u32)delta * 4; 
     u32 rate = nom / denom;
-    return (u16)rate;
+    return rate;
   } else {
     return 0;
   }
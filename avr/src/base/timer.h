@@ -56,7 +56,7 @@ extern void timer_delay_100us(u16 timeout);
 // 16 bit hw timer with 4us resolution
 inline void timer_hw_reset(void) { TCNT1 = 0; }
 inline u16  timer_hw_get(void) { return TCNT1; }
-extern u16 timer_hw_calc_rate_kbs(u16 bytes, u16 delta);
+extern u32 timer_hw_calc_rate_kbs(u16 bytes, u16 delta); // in 1/100 KB/s
 
   
 #endif
@@ -83,7 +83,7 @@ void uart_send_time_stamp_spc_ext(u32 ts)
   uart_send_data(buf,12);
 }
 
-void uart_send_rate_kbs(u16 kbs)
+void uart_send_rate_kbs(u32 kbs)
 {
   dword_to_dec(kbs, buf, 6, 2);
   uart_send_data(buf,7);
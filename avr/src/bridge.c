@@ -29,6 +29,7 @@
 #include "pkt_buf.h"
 #include "pb_proto.h"
 #include "uartutil.h"
+#include "uart.h"
 #include "param.h"
 #include "dump.h"
 #include "timer.h"
@@ -42,13 +43,34 @@
 #include "pio.h"
 #include "net/eth.h"
 #include "net/net.h"
+#include "net/arp.h"
+#include "net/ip.h"
 
 #define FLAG_ONLINE         1
 #define FLAG_SEND_MAGIC     2
 #define FLAG_FIRST_TRANSFER 4
+#define FLAG_SEND_CAPS      8
+#define FLAG_SEND_CALIB     16
+#define FLAG_SAVE_PARAM     32
+#define FLAG_SEND_ANY       (FLAG_SEND_MAGIC | FLAG_SEND_CAPS | FLAG_SEND_CALIB)
+
+// recv delay calibration
+#define CALIB_SIZE          256   // pattern bytes after eth header
+#define CALIB_ROUNDS        4     // good echos required per delay
+#define CALIB_TIMEOUT       5000  // = 500ms in 100us ticks
 
 static u08 flags;
 static u08 req_is_pending;
+static u08 cut_through;
+static u08 caps;
+static u08 calib_delay; // delay under test or 0 if not calibrating
+static u08 calib_round;
+static u32 calib_ts;
+static u08 calib_mac[6];
+static u08 amiga_ip[4]; // learned from outgoing packets
+static u08 amiga_ip_valid;
+static u16 filter_types[PBPROTO_FILTER_MAX]; // eth types read by the Amiga
+static u08 filter_num; // 0 = all
 
 static void trigger_request(void)
 {
@@ -67,16 +89,303 @@ static void trigger_request(void)
   }
 }
 
+// ----- recv delay calibration -----
+
+// the Amiga echoes the calib frames. the pattern toggles (nearly) all data
+// lines from byte to byte to stress the recv burst timing
+static u08 calib_byte(u08 i)
+{
+  return (i & 1) ? ~i : i;
+}
+
+static void calib_send(void)
+{
+  pb_proto_recv_delay = calib_delay;
+  calib_ts = time_stamp;
+  flags |= FLAG_SEND_CALIB;
+  trigger_request();
+}
+
+static void calib_done(u08 delay)
+{
+  calib_delay = 0;
+  pb_proto_recv_delay = delay;
+
+  uart_send_time_stamp_spc();
+  uart_send_pstring(PSTR("[CALIB] delay: "));
+  uart_send_hex_byte(delay);
+  uart_send_crlf();
+
+  // the EEPROM write blocks: save once the bridge is idle
+  param_calib_set(calib_mac, delay);
+  flags |= FLAG_SAVE_PARAM;
+}
+
+static void calib_start(const u08 *mac)
+{
+  uart_send_time_stamp_spc();
+  uart_send_pstring(PSTR("[CALIB] start\r\n"));
+
+  net_copy_mac(mac, calib_mac);
+  calib_delay = 1;
+  calib_round = 0;
+  calib_send();
+}
+
+// current delay failed: try next slower one
+static void calib_next(void)
+{
+  if(global_verbose) {
+    uart_send_time_stamp_spc();
+    uart_send_pstring(PSTR("[CALIB] fail: "));
+    uart_send_hex_byte(calib_delay);
+    uart_send_crlf();
+  }
+
+  calib_delay++;
+  calib_round = 0;
+  if(calib_delay >= PBPROTO_RECV_DELAY_DEFAULT) {
+    calib_done(PBPROTO_RECV_DELAY_DEFAULT);
+  } else {
+    calib_send();
+  }
+}
+
+static void calib_check(const u08 *buf, u16 size)
+{
+  if(calib_delay == 0) {
+    return;
+  }
+
+  // compare echo
+  u08 ok = (size == ETH_HDR_SIZE + CALIB_SIZE);
+  const u08 *data = buf + ETH_HDR_SIZE;
+  for(u16 i=0;ok && (i<CALIB_SIZE);i++) {
+    if(data[i] != calib_byte((u08)i)) {
+      ok = 0;
+    }
+  }
+
+  if(!ok) {
+    calib_next();
+  }
+  else if(++calib_round < CALIB_ROUNDS) {
+    calib_send();
+  }
+  // passed: keep one step of margin
+  else {
+    u08 delay = calib_delay + 1;
+    if(delay > PBPROTO_RECV_DELAY_DEFAULT) {
+      delay = PBPROTO_RECV_DELAY_DEFAULT;
+    }
+    calib_done(delay);
+  }
+}
+
+// ----- ARP offload -----
+
+// learn the IP of the Amiga from the packets it sends
+static void arp_learn(const u08 *buf, u16 size)
+{
+  if(size <= ETH_HDR_SIZE) {
+    return;
+  }
+
+  const u08 *pl_buf = buf + ETH_HDR_SIZE;
+  u16 pl_size = size - ETH_HDR_SIZE;
+  const u08 *ip = 0;
+  u16 type = eth_get_pkt_type(buf);
+  if(type == ETH_TYPE_IPV4) {
+    if(pl_size >= IP_MIN_HDR_SIZE) {
+      ip = ip_get_src_ip(pl_buf);
+    }
+  }
+  else if(type == ETH_TYPE_ARP) {
+    if(arp_is_ipv4(pl_buf, pl_size)) {
+      ip = arp_get_src_ip(pl_buf);
+    }
+  }
+
+  // no address yet (e.g. DHCP or ARP probe)
+  if((ip == 0) || net_compare_ip(ip, net_zero_ip)) {
+    return;
+  }
+  if(amiga_ip_valid && net_compare_ip(ip, amiga_ip)) {
+    return;
+  }
+
+  net_copy_ip(ip, amiga_ip);
+  amiga_ip_valid = 1;
+  uart_send_time_stamp_spc();
+  uart_send_pstring(PSTR("[ARP] amiga ip: "));
+  net_dump_ip(amiga_ip);
+  uart_send_crlf();
+}
+
+// answer the peeked PIO packet if its an ARP request for the Amiga.
+// returns 1 if the packet was consumed
+static u08 arp_offload(u16 size)
+{
+  // most packets are not ARP
+  if((eth_get_pkt_type(pkt_buf) != ETH_TYPE_ARP) ||
+     (size < ETH_HDR_SIZE + ARP_SIZE)) {
+    return 0;
+  }
+  if(pio_peek(pkt_buf, ETH_HDR_SIZE + ARP_SIZE, &size) != PIO_OK) {
+    return 0;
+  }
+  u08 *arp_buf = pkt_buf + ETH_HDR_SIZE;
+  if(!arp_is_ipv4(arp_buf, ARP_SIZE) ||
+     (arp_get_op(arp_buf) != ARP_REQUEST) ||
+     !net_compare_ip(arp_get_tgt_ip(arp_buf), amiga_ip)) {
+    return 0;
+  }
+
+  // consume request and reply it to the sender
+  if(pio_util_recv_packet(&size) != PIO_OK) {
+    return 1;
+  }
+  arp_make_reply(arp_buf, param.mac_addr, amiga_ip);
+  net_copy_mac(pkt_buf + ETH_OFF_SRC_MAC, pkt_buf + ETH_OFF_TGT_MAC);
+  net_copy_mac(param.mac_addr, pkt_buf + ETH_OFF_SRC_MAC);
+  pio_util_send_packet(ETH_HDR_SIZE + ARP_SIZE);
+
+  if(global_verbose) {
+    uart_send_time_stamp_spc();
+    uart_send_pstring(PSTR("[ARP] reply: "));
+    net_dump_ip(arp_get_tgt_ip(arp_buf));
+    uart_send_crlf();
+  }
+  return 1;
+}
+
+// drop packets of eth types the Amiga does not read. it would drop them
+// anyway but only after a full transfer
+static u08 type_drop(void)
+{
+  u16 type = eth_get_pkt_type(pkt_buf);
+  for(u08 i=0;i<filter_num;i++) {
+    if(filter_types[i] == type) {
+      return 0;
+    }
+  }
+  pio_drop();
+  stats_get(STATS_ID_PIO_RX)->drop++;
+
+  if(global_verbose) {
+    uart_send_time_stamp_spc();
+    uart_send_pstring(PSTR("[DROP] type: "));
+    uart_send_hex_word(type);
+    uart_send_crlf();
+  }
+  return 1;
+}
+
+// handle the next PIO packet in the firmware if possible.
+// returns 1 if it was consumed
+static u08 offload_pkt(void)
+{
+  u08 arp = param.arp_offload && amiga_ip_valid;
+  if(!(flags & FLAG_ONLINE) || (!arp && (filter_num == 0))) {
+    return 0;
+  }
+
+  // peek eth header only
+  u16 size;
+  if(pio_peek(pkt_buf, ETH_HDR_SIZE, &size) != PIO_OK) {
+    return 0;
+  }
+  // our ARP replies do not depend on the Amiga reading ARP
+  if(arp && arp_offload(size)) {
+    return 1;
+  }
+  if(filter_num != 0) {
+    return type_drop();
+  }
+  return 0;
+}
+
+// number of PIO packets for the Amiga. ARP requests for it are answered
+// on-box and never cross the parallel port
+static u08 pio_pending(void)
+{
+  u08 n = pio_has_recv();
+  while((n > 0) && offload_pkt()) {
+    n = pio_has_recv();
+  }
+  return n;
+}
+
 // ----- magic packets -----
 
-static void magic_online(const u08 *buf)
+static void filter_reset(void)
+{
+  if(filter_num != 0) {
+    filter_num = 0;
+    pio_filter(filter_types, 0);
+  }
+  pio_mcast(0, 0);
+}
+
+// find value of a tag in the TLV list behind the header of a magic packet
+static const u08 *find_tlv(const u08 *buf, u16 size, u08 tag, u08 min_len)
+{
+  const u08 *ptr = buf + ETH_HDR_SIZE;
+  const u08 *end = buf + size;
+  while(ptr + 2 <= end) {
+    u08 t = ptr[0];
+    u08 l = ptr[1];
+    if((t == PBPROTO_TLV_END) || (ptr + 2 + l > end)) {
+      break;
+    }
+    if((t == tag) && (l >= min_len)) {
+      return ptr + 2;
+    }
+    ptr += 2 + l;
+  }
+  return 0;
+}
+
+static void magic_online(const u08 *buf, u16 size)
 {
   uart_send_time_stamp_spc();
   uart_send_pstring(PSTR("[MAGIC] online\r\n"));
   flags |= FLAG_ONLINE | FLAG_FIRST_TRANSFER;
+  // a new session sends its own filter
+  filter_reset();
+
+  // the Amiga offers its capabilities in a TLV list.
+  // reply the ones we agree on. older drivers send none and get no reply
+  const u08 *ver = find_tlv(buf, size, PBPROTO_TLV_VERSION, 2);
+  const u08 *cap = find_tlv(buf, size, PBPROTO_TLV_CAPS, 1);
+  caps = (cap != 0) ? (*cap & PBPROTO_CAP_ALL) : 0;
+  if(ver != 0) {
+    uart_send_time_stamp_spc();
+    uart_send_pstring(PSTR("[MAGIC] driver: "));
+    uart_send_hex_byte(ver[0]);
+    uart_send('.');
+    uart_send_hex_byte(ver[1]);
+    uart_send_pstring(PSTR(" caps: "));
+    uart_send_hex_byte(caps);
+    uart_send_crlf();
+    flags |= FLAG_SEND_CAPS;
+    trigger_request();
+  }
 
-  // validate mac address and if it does not match then reconfigure PIO
+  // use stored recv delay of this Amiga or calibrate it if it can echo
   const u08 *src_mac = eth_get_src_mac(buf);
+  u08 delay = param_calib_get(src_mac);
+  calib_delay = 0;
+  if(delay != 0) {
+    pb_proto_recv_delay = delay;
+  } else {
+    pb_proto_recv_delay = PBPROTO_RECV_DELAY_DEFAULT;
+    if(caps & PBPROTO_CAP_CALIB) {
+      calib_start(src_mac);
+    }
+  }
+
+  // validate mac address and if it does not match then reconfigure PIO
   if(!net_compare_mac(param.mac_addr, src_mac)) {
     // update mac param and save
     net_copy_mac(src_mac, param.mac_addr);
@@ -84,7 +393,7 @@ static void magic_online(const u08 *buf)
 
     // re-configure PIO
     pio_exit();
-    pio_init(param.mac_addr, PIO_INIT_BROAD_CAST);
+    pio_init(param.mac_addr, PIO_INIT_BROAD_CAST, param.rx_pages);
   }
 }
 
@@ -92,7 +401,37 @@ static void magic_offline(void)
 {
   uart_send_time_stamp_spc();
   uart_send_pstring(PSTR("[MAGIC] offline\r\n"));
-  flags &= ~FLAG_ONLINE;
+  flags &= ~(FLAG_ONLINE | FLAG_SEND_CALIB);
+  calib_delay = 0;
+  filter_reset();
+}
+
+// the Amiga tells us the eth types it reads so we can drop the others.
+// a missing or empty list means all types
+static void magic_filter(const u08 *buf, u16 size)
+{
+  const u08 *tlv = find_tlv(buf, size, PBPROTO_TLV_TYPES, 0);
+  u08 num = (tlv != 0) ? (tlv[-1] / 2) : 0;
+  if(num > PBPROTO_FILTER_MAX) {
+    num = 0;
+  }
+  for(u08 i=0;i<num;i++) {
+    filter_types[i] = net_get_word(tlv + i * 2);
+  }
+  filter_num = num;
+
+  uart_send_time_stamp_spc();
+  uart_send_pstring(PSTR("[MAGIC] filter:"));
+  if(num == 0) {
+    uart_send_pstring(PSTR(" all"));
+  }
+  for(u08 i=0;i<num;i++) {
+    uart_send_spc();
+    uart_send_hex_word(filter_types[i]);
+  }
+  uart_send_crlf();
+
+  pio_filter(filter_types, filter_num);
 }
 
 static void magic_loopback(u16 size)
@@ -111,11 +450,38 @@ static void request_magic(void)
   trigger_request();
 }
 
+// the Amiga tells us its multicast groups and the PIO hashes them.
+// no list means none and an empty list all groups
+static void magic_mcast(const u08 *buf, u16 size)
+{
+  const u08 *tlv = find_tlv(buf, size, PBPROTO_TLV_MCAST, 0);
+  u08 num = 0;
+  if(tlv != 0) {
+    num = tlv[-1] / 6;
+    if((num == 0) || (num > PBPROTO_MCAST_MAX)) {
+      num = PIO_MCAST_ALL;
+    }
+  }
+
+  uart_send_time_stamp_spc();
+  uart_send_pstring(PSTR("[MAGIC] mcast: "));
+  if(num == PIO_MCAST_ALL) {
+    uart_send_pstring(PSTR("all"));
+  } else {
+    uart_send_hex_byte(num);
+  }
+  uart_send_crlf();
+
+  pio_mcast(tlv, num);
+}
+
 // ----- packet callbacks -----
 
 // the Amiga requests a new packet
 static u08 fill_pkt(u08 *buf, u16 max_size, u16 *size)
 {
+  u08 status = PBPROTO_STATUS_OK;
+
   // need to send a magic?
   if((flags & FLAG_SEND_MAGIC) == FLAG_SEND_MAGIC) {
     flags &= ~FLAG_SEND_MAGIC;
@@ -126,9 +492,63 @@ static u08 fill_pkt(u08 *buf, u16 max_size, u16 *size)
     net_put_word(pkt_buf + ETH_OFF_TYPE, ETH_TYPE_MAGIC_ONLINE);
 
     *size = ETH_HDR_SIZE;
-  } else {
+  }
+  // need to send agreed caps?
+  else if(flags & FLAG_SEND_CAPS) {
+    flags &= ~FLAG_SEND_CAPS;
+
+    // build caps packet
+    net_copy_zero_mac(pkt_buf + ETH_OFF_TGT_MAC);
+    net_copy_mac(param.mac_addr, pkt_buf + ETH_OFF_SRC_MAC);
+    net_put_word(pkt_buf + ETH_OFF_TYPE, ETH_TYPE_MAGIC_CAPS);
+    u08 *tlv = pkt_buf + ETH_HDR_SIZE;
+    tlv[0] = PBPROTO_TLV_VERSION;
+    tlv[1] = 2;
+    tlv[2] = VERSION_MAJ;
+    tlv[3] = VERSION_MIN;
+    tlv[4] = PBPROTO_TLV_CAPS;
+    tlv[5] = 1;
+    tlv[6] = caps;
+    tlv[7] = PBPROTO_TLV_END;
+
+    *size = ETH_HDR_SIZE + 8;
+  }
+  // need to send calibration pattern?
+  else if(flags & FLAG_SEND_CALIB) {
+    flags &= ~FLAG_SEND_CALIB;
+
+    // build calib packet
+    net_copy_zero_mac(pkt_buf + ETH_OFF_TGT_MAC);
+    net_copy_mac(param.mac_addr, pkt_buf + ETH_OFF_SRC_MAC);
+    net_put_word(pkt_buf + ETH_OFF_TYPE, ETH_TYPE_MAGIC_CALIB);
+    u08 *data = pkt_buf + ETH_HDR_SIZE;
+    for(u16 i=0;i<CALIB_SIZE;i++) {
+      data[i] = calib_byte((u08)i);
+    }
+
+    *size = ETH_HDR_SIZE + CALIB_SIZE;
+  }
+  // nothing pending (e.g. next frame of a multi transfer)
+  // PIO packets are held back while the recv delay is calibrated
+  else if((calib_delay != 0) || (pio_pending() == 0)) {
+    *size = 0;
+  }
+  else {
     // pending PIO packet?
-    pio_util_recv_packet(size);
+    u08 result;
+    if(cut_through) {
+      // stream it directly from PIO to the Amiga
+      result = pio_util_recv_stream(size);
+      if(result == PIO_OK) {
+        status = PBPROTO_STATUS_STREAM;
+      }
+    } else {
+      result = pio_util_recv_packet(size);
+    }
+    // broken packet was dropped: send empty one
+    if(result == PIO_IO_ERR) {
+      *size = 0;
+    }
 
     // report first packet transfer
     if(flags & FLAG_FIRST_TRANSFER) {
@@ -140,7 +560,7 @@ static u08 fill_pkt(u08 *buf, u16 max_size, u16 *size)
 
   req_is_pending = 0;
 
-  return PBPROTO_STATUS_OK;  
+  return status;
 }
 
 // handle incoming packet from Amiga
@@ -148,9 +568,15 @@ static u08 proc_pkt(const u08 *buf, u16 size)
 {
   // get eth type
   u16 eth_type = eth_get_pkt_type(buf);
+
+  // cut-through: packet is already in PIO. send it unless its our own magic
+  if(cut_through) {
+    pio_util_send_stream(eth_is_magic_type(eth_type) ? 0 : size);
+  }
+
   switch(eth_type) {
     case ETH_TYPE_MAGIC_ONLINE:
-      magic_online(buf);
+      magic_online(buf, size);
       break;
     case ETH_TYPE_MAGIC_OFFLINE:
       magic_offline();
@@ -158,9 +584,21 @@ static u08 proc_pkt(const u08 *buf, u16 size)
     case ETH_TYPE_MAGIC_LOOPBACK:
       magic_loopback(size);
       break;
+    case ETH_TYPE_MAGIC_CALIB:
+      calib_check(buf, size);
+      break;
+    case ETH_TYPE_MAGIC_FILTER:
+      magic_filter(buf, size);
+      break;
+    case ETH_TYPE_MAGIC_MCAST:
+      magic_mcast(buf, size);
+      break;
     default:
       // send packet via pio
-      pio_util_send_packet(size);
+      if(!cut_through) {
+        pio_util_send_packet(size);
+      }
+      arp_learn(buf, size);
       // if a packet arrived and we are not online then request online state
       if((flags & FLAG_ONLINE)==0) {
         request_magic();
@@ -180,12 +618,20 @@ u08 bridge_loop(void)
   uart_send_pstring(PSTR("[BRIDGE] on\r\n"));
 
   pb_proto_init(fill_pkt, proc_pkt, pkt_buf, PKT_BUF_SIZE);
-  pio_init(param.mac_addr, pio_util_get_init_flags());
+  pio_init(param.mac_addr, pio_util_get_init_flags(), param.rx_pages);
   stats_reset();
 
+  // cut-through mode is fixed while bridge is running
+  cut_through = param.cut_through;
+  pb_proto_send_stream = cut_through;
+
   // online flag
   flags = 0;
+  caps = 0;
+  calib_delay = 0;
   req_is_pending = 0;
+  amiga_ip_valid = 0;
+  filter_num = 0;
 
   u08 flow_control = param.flow_ctl;
   u08 limit_flow = 0;
@@ -200,9 +646,30 @@ u08 bridge_loop(void)
     // handle pbproto
     pb_util_handle();
 
+    // more internal frames queued for the Amiga?
+    if(!req_is_pending && (flags & FLAG_SEND_ANY)) {
+      trigger_request();
+    }
+
+    // calibration echo lost?
+    if((calib_delay != 0) && ((time_stamp - calib_ts) > CALIB_TIMEOUT)) {
+      calib_next();
+    }
+
     // incoming packet via PIO available?
+    // ARP requests for the Amiga are answered before it is woken up.
+    // a paused transfer keeps its frame in pkt_buf: leave the PIO alone
     u08 n = pio_has_recv();
-    if(n>0) {
+    u08 busy = pb_proto_busy();
+    if((n>0) && !busy && !req_is_pending && (calib_delay == 0)) {
+      n = pio_pending();
+    }
+    // store a new calibration while nothing waits on either side
+    if((n==0) && !busy && !req_is_pending && (flags & FLAG_SAVE_PARAM)) {
+      flags &= ~FLAG_SAVE_PARAM;
+      param_save();
+    }
+    if((n>0) && !busy) {
       // show first incoming packet
       if(first) {
         first = 0;
@@ -211,9 +678,12 @@ u08 bridge_loop(void)
       }
 
       // if we are online then request the packet receiption
+      // (held back while calibrating)
       if(flags & FLAG_ONLINE) {
-        // if no request is pending then request it
-        trigger_request();
+        if(calib_delay == 0) {
+          // if no request is pending then request it
+          trigger_request();
+        }
       }  
       // offline: get and drop pio packet
       else {
@@ -255,7 +725,13 @@ u08 bridge_loop(void)
     }
   }
 
+  if(flags & FLAG_SAVE_PARAM) {
+    param_save();
+  }
+
   stats_dump_all();
+  pio_util_dump_rx_level();
+  pio_util_dump_spi_ops();
   pio_exit();
 
   uart_send_time_stamp_spc();
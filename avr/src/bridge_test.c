@@ -103,7 +103,7 @@ u08 bridge_test_loop(void)
   uart_send_pstring(PSTR("[BRIDGE_TEST] on\r\n"));
 
   pb_proto_init(fill_pkt, proc_pkt, pkt_buf, PKT_BUF_SIZE);
-  pio_init(param.mac_addr, pio_util_get_init_flags());
+  pio_init(param.mac_addr, pio_util_get_init_flags(), param.rx_pages);
   stats_reset();
   
   while(run_mode == RUN_MODE_BRIDGE_TEST) {
@@ -117,7 +117,8 @@ u08 bridge_test_loop(void)
     pb_util_handle();
 
     // incoming packet via PIO?
-    if(pio_has_recv()) {
+    // a paused transfer keeps its frame in pkt_buf
+    if(!pb_proto_busy() && pio_has_recv()) {
       u16 size;
       if(pio_util_recv_packet(&size) == PIO_OK) {
         // handle ARP?
@@ -31,6 +31,8 @@
 #include "net/net.h"
 #include "param.h"
 #include "stats.h"
+#include "pio.h"
+#include "pio_util.h"
 
 COMMAND(cmd_quit)
 {
@@ -80,6 +82,12 @@ COMMAND(cmd_param_reset)
   return CMD_OK;
 }
 
+COMMAND(cmd_param_calib_clear)
+{
+  param_calib_clear();
+  return CMD_OK;
+}
+
 COMMAND(cmd_param_toggle)
 {
   u08 group = argv[0][0];
@@ -100,6 +108,18 @@ COMMAND(cmd_param_toggle)
       default: return CMD_PARSE_ERROR;
     }
   }
+  else if(group == 'c') {
+    switch(type) {
+      case 't': val = &param.cut_through; result = CMD_OK_RESTART; break;
+      default: return CMD_PARSE_ERROR;
+    }
+  }
+  else if(group == 'a') {
+    switch(type) {
+      case 'o': val = &param.arp_offload; break;
+      default: return CMD_PARSE_ERROR;
+    }
+  }
   else {
     return CMD_PARSE_ERROR;
   }
@@ -118,6 +138,35 @@ COMMAND(cmd_param_toggle)
   return result;
 }
 
+COMMAND(cmd_param_byte)
+{
+  u08 group = argv[0][0];
+  u08 type = argv[0][1];
+  u08 *val = 0;
+
+  if(group == 'e') {
+    switch(type) {
+      case 'r': val = &param.rx_pages; break;
+      default: return CMD_PARSE_ERROR;
+    }
+  }
+  else {
+    return CMD_PARSE_ERROR;
+  }
+
+  if(argc == 1) {
+    return CMD_PARSE_ERROR;
+  } else {
+    u08 new_val;
+    if(parse_byte(argv[1],&new_val)) {
+      *val = new_val;
+    } else {
+      return CMD_PARSE_ERROR;
+    }
+  }
+  return CMD_OK_RESTART;
+}
+
 COMMAND(cmd_param_word)
 {
   u08 group = argv[0][0];
@@ -176,12 +225,15 @@ COMMAND(cmd_param_ip_addr)
 COMMAND(cmd_stats_dump)
 {
   stats_dump_all();
+  pio_util_dump_rx_level();
+  pio_util_dump_spi_ops();
   return CMD_OK;
 }
 
 COMMAND(cmd_stats_reset)
 {
   stats_reset();
+  pio_control(PIO_CONTROL_RX_RESET, 0);
   return CMD_OK;
 }
 
@@ -194,6 +246,7 @@ CMD_NAME("p", cmd_param_dump, "print parameters");
 CMD_NAME("ps", cmd_param_save, "save parameters to EEPROM");
 CMD_NAME("pl", cmd_param_load, "load parameters from EEPROM" );
 CMD_NAME("pr", cmd_param_reset, "reset parameters to default" );
+CMD_NAME("pc", cmd_param_calib_clear, "clear calibrated recv delays" );
   // stats
 CMD_NAME("sd", cmd_stats_dump, "dump statistics" );
 CMD_NAME("sr", cmd_stats_reset, "reset statistics" );
@@ -201,6 +254,9 @@ CMD_NAME("sr", cmd_stats_reset, "reset statistics" );
 CMD_NAME("m", cmd_gen_m, "mac address of device <mac>" );
 CMD_NAME("fd", cmd_gen_fd, "set full duple mode [on]" );
 CMD_NAME("fc", cmd_gen_fc, "set flow control [on]" );
+CMD_NAME("ct", cmd_gen_ct, "cut-through PIO <-> plipbox [on]" );
+CMD_NAME("ao", cmd_gen_ao, "answer ARP for the Amiga IP [on]" );
+CMD_NAME("er", cmd_gen_er, "eth rx buffer size in 256 byte pages <n>" );
   // test
 CMD_NAME("tl", cmd_gen_tl,  "test packet length <n>");
 CMD_NAME("tt", cmd_gen_tt, "test packet eth type <n>" );
@@ -218,6 +274,7 @@ const cmd_table_t PROGMEM cmd_table[] = {
   CMD_ENTRY(cmd_param_save),
   CMD_ENTRY(cmd_param_load),
   CMD_ENTRY(cmd_param_reset),
+  CMD_ENTRY(cmd_param_calib_clear),
   // stats
   CMD_ENTRY(cmd_stats_dump),
   CMD_ENTRY(cmd_stats_reset),
@@ -225,6 +282,9 @@ const cmd_table_t PROGMEM cmd_table[] = {
   CMD_ENTRY_NAME(cmd_param_mac_addr, cmd_gen_m),
   CMD_ENTRY_NAME(cmd_param_toggle, cmd_gen_fd),
   CMD_ENTRY_NAME(cmd_param_toggle, cmd_gen_fc),
+  CMD_ENTRY_NAME(cmd_param_toggle, cmd_gen_ct),
+  CMD_ENTRY_NAME(cmd_param_toggle, cmd_gen_ao),
+  CMD_ENTRY_NAME(cmd_param_byte, cmd_gen_er),
   // test
   CMD_ENTRY_NAME(cmd_param_word, cmd_gen_tl),
   CMD_ENTRY_NAME(cmd_param_word, cmd_gen_tt),
@@ -28,6 +28,7 @@
 
 #include "stats.h"
 #include "pb_test.h"
+#include "pio_test.h"
 #include "main.h"
 #include "uartutil.h"
 
@@ -76,6 +77,11 @@ COMMAND_KEY(cmd_toggle_auto_mode)
   pb_test_toggle_auto();
 }
 
+COMMAND_KEY(cmd_pio_bench)
+{
+  pio_test_bench();
+}
+
 COMMAND_KEY(cmd_toggle_verbose)
 {
   global_verbose = !global_verbose;
@@ -93,6 +99,7 @@ CMDKEY_HELP(cmd_toggle_verbose, "toggle verbose output");
 CMDKEY_HELP(cmd_send_test_packet, "send a test packet (pbtest mode)");
 CMDKEY_HELP(cmd_send_test_packet_silent, "send a test packet (silent) (pbtest mode)");
 CMDKEY_HELP(cmd_toggle_auto_mode, "toggle auto send (pbtest mode)");
+CMDKEY_HELP(cmd_pio_bench, "measure PIO transfer rate (piotest mode)");
 
 const cmdkey_table_t PROGMEM cmdkey_table[] = {
   CMDKEY_ENTRY('1', cmd_enter_bridge_mode),
@@ -105,5 +112,6 @@ const cmdkey_table_t PROGMEM cmdkey_table[] = {
   CMDKEY_ENTRY('p', cmd_send_test_packet),
   CMDKEY_ENTRY('P', cmd_send_test_packet_silent),
   CMDKEY_ENTRY('a', cmd_toggle_auto_mode),
+  CMDKEY_ENTRY('b', cmd_pio_bench),
   { 0,0 }
 };
@@ -211,9 +211,15 @@ void dump_pb_cmd(const pb_proto_stat_t *ps)
   switch(cmd) {
     case PBPROTO_CMD_SEND:
     case PBPROTO_CMD_SEND_BURST:
+    case PBPROTO_CMD_SEND_MULTI:
+    case PBPROTO_CMD_SEND_STROBE:
+    case PBPROTO_CMD_SEND_BURST_CRC:
       break;
     case PBPROTO_CMD_RECV:
     case PBPROTO_CMD_RECV_BURST:
+    case PBPROTO_CMD_RECV_MULTI:
+    case PBPROTO_CMD_RECV_STROBE:
+    case PBPROTO_CMD_RECV_BURST_CRC:
       break;
     default:
       is_valid = 0;
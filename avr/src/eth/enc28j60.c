@@ -15,6 +15,7 @@
 #include "enc28j60.h"
 #include "spi.h"
 #include "pio.h"
+#include "timer.h"
 
 // ENC28J60 Control Registers
 // Control register definitions are a combination of address,
@@ -39,7 +40,7 @@
 #define ERXST           (0x08|0x00)
 #define ERXND           (0x0A|0x00)
 #define ERXRDPT         (0x0C|0x00)
-// #define ERXWRPT         (0x0E|0x00)
+#define ERXWRPT         (0x0E|0x00)
 #define EDMAST          (0x10|0x00)
 #define EDMAND          (0x12|0x00)
 // #define EDMADST         (0x14|0x00)
@@ -62,7 +63,7 @@
 #define EPMM6            (0x0E|0x20)
 #define EPMM7            (0x0F|0x20)
 #define EPMCS           (0x10|0x20)
-// #define EPMO            (0x14|0x20)
+#define EPMO            (0x14|0x20)
 #define EWOLIE           (0x16|0x20)
 #define EWOLIR           (0x17|0x20)
 #define ERXFCON          (0x18|0x20)
@@ -236,23 +237,68 @@
 // 1518 
 // sum: 1524
 
-#define RXSTART_INIT        0x0000  // start of RX buffer, room for 4 packets
-#define RXSTOP_INIT         0x19FF  // end of RX buffer
+// tx slot layout
+// 1 byte control
+// 1518
+// 7 byte status vector
+// sum: 1526
+
+// the RX buffer size is given in 256 byte pages at init. the rest is TX
+// with 2 alternating slots if they fit (default 0x14: room for 3 packets)
+#define RXSTART_INIT        0x0000  // start of RX buffer
+#define RX_PAGES_MIN        0x08    // 2 TX slots
+#define RX_PAGES_MAX        0x1A    // 1 TX slot
                             
-#define TXSTART_INIT        0x1A00  // start of TX buffer, room for 1 packet
 #define TXSTOP_INIT         0x1FFF  // end of TX buffer
+#define TXSLOT_SIZE         0x0600
                             
 // max frame length which the conroller will accept:
 // (note: maximum ethernet frame length would be 1518)
 #define MAX_FRAMELEN      1518        
 
+#define RD_PTR_UNKNOWN    0xffff
+// free the rx space once a quarter of the ring is held back (or when idle)
+#define RX_RELEASE_BYTES  ((rx_stop + 1 - RXSTART_INIT) >> 2)
+
+// sample /INT instead of polling EPKTCNT via SPI
+#if defined(ETH_IRQ) && defined(ETH_INT_MASK)
+#define USE_INT_PIN
+#endif
+
 static u08 Enc28j60Bank;
 static u16 gNextPacketPtr;
+static u16 rd_ptr; // shadow of ERDPT
+static u16 rx_rel_ptr; // next packet ptr at the last ERXRDPT update
+static u16 tx_start; // shadow of ETXST
+static u08 spi_ops; // chip selects since the start of the operation
+static u08 rx_ops; // ... of the last recv
+static u08 tx_ops; // ... of the last send
+static u16 rx_stop; // end of RX buffer
+static u16 tx_first; // start of TX slots
+static u16 tx_second; // = tx_first if single slot
+static u16 tx_slot; // start of slot to fill next
+static u08 rx_pages;
+static u08 rx_max_pages;
+static u08 rx_max_pkts;
 static u08 is_full_duplex;
 static u08 rev;
+static u08 rx_filter; // ERXFCON set up by init
+static u08 rx_pattern; // broadcasts by pattern match
+static u08 rx_mcast; // HTEN or MCEN
+#ifdef USE_INT_PIN
+static u08 poll_tick; // 10ms tick of last EPKTCNT read with /INT high
+static u08 last_pkts; // EPKTCNT of the last read
+#endif
+
+// count chip selects to see the cost of an operation
+inline static void cs_enable(void)
+{
+  spi_ops++;
+  spi_enable_eth();
+}
 
 static uint8_t readOp (uint8_t op, uint8_t address) {
-    spi_enable_eth();
+    cs_enable();
     spi_out(op | (address & ADDR_MASK));
     if (address & 0x80)
         spi_out(0x00);
@@ -262,26 +308,33 @@ static uint8_t readOp (uint8_t op, uint8_t address) {
 }
 
 static void writeOp (uint8_t op, uint8_t address, uint8_t data) {
-    spi_enable_eth();
+    cs_enable();
     spi_out(op | (address & ADDR_MASK));
     spi_out(data);
     spi_disable_eth();
 }
 
 static void readBuf(uint16_t len, uint8_t* data) {
-    spi_enable_eth();
+    cs_enable();
     spi_out(ENC28J60_READ_BUF_MEM);
-    while (len--) {
-        *data++ = spi_in();
-    }
+    spi_in_block(data, len);
     spi_disable_eth();
 }
 
+// EIE..ECON1 are mapped in all banks. otherwise only the BSEL bits that
+// differ are cleared or set, so a switch from or to bank 0 is one op
 static void SetBank (uint8_t address) {
-    if ((address & BANK_MASK) != Enc28j60Bank) {
-        writeOp(ENC28J60_BIT_FIELD_CLR, ECON1, ECON1_BSEL1|ECON1_BSEL0);
-        Enc28j60Bank = address & BANK_MASK;
-        writeOp(ENC28J60_BIT_FIELD_SET, ECON1, Enc28j60Bank>>5);
+    if ((address & ADDR_MASK) >= EIE)
+        return;
+    uint8_t bank = address & BANK_MASK;
+    if (bank != Enc28j60Bank) {
+        uint8_t clr = Enc28j60Bank & ~bank;
+        uint8_t set = bank & ~Enc28j60Bank;
+        if (clr)
+            writeOp(ENC28J60_BIT_FIELD_CLR, ECON1, clr>>5);
+        if (set)
+            writeOp(ENC28J60_BIT_FIELD_SET, ECON1, set>>5);
+        Enc28j60Bank = bank;
     }
 }
 
@@ -290,11 +343,11 @@ static uint8_t readRegByte (uint8_t address) {
     return readOp(ENC28J60_READ_CTRL_REG, address);
 }
 
-#if 0
 static uint16_t readReg(uint8_t address) {
-	return readRegByte(address) + (readRegByte(address+1) << 8);
+    SetBank(address);
+    uint8_t lo = readOp(ENC28J60_READ_CTRL_REG, address);
+    return lo + (readOp(ENC28J60_READ_CTRL_REG, address+1) << 8);
 }
-#endif
 
 static void writeRegByte (uint8_t address, uint8_t data) {
     SetBank(address);
@@ -302,8 +355,9 @@ static void writeRegByte (uint8_t address, uint8_t data) {
 }
 
 static void writeReg(uint8_t address, uint16_t data) {
-    writeRegByte(address, data);
-    writeRegByte(address + 1, data >> 8);
+    SetBank(address);
+    writeOp(ENC28J60_WRITE_CTRL_REG, address, data);
+    writeOp(ENC28J60_WRITE_CTRL_REG, address + 1, data >> 8);
 }
 
 static uint16_t readPhyByte (uint8_t address) {
@@ -326,17 +380,28 @@ static void writePhy (uint8_t address, uint16_t data) {
 
 // Functions to enable/disable broadcast filter bits
 // With the bit set, broadcast packets are filtered.
+static void write_rx_filter(void)
+{
+  u08 val = rx_filter | rx_mcast;
+  if(rx_pattern) {
+    val = (val & ~ERXFCON_BCEN) | ERXFCON_PMEN;
+  }
+  writeRegByte(ERXFCON, val);
+}
+
 static inline void enc28j60_enable_broadcast ( void ) 
 {
-  writeRegByte(ERXFCON, ERXFCON_UCEN|ERXFCON_CRCEN/*|ERXFCON_PMEN*/|ERXFCON_BCEN);
+  rx_filter = ERXFCON_UCEN|ERXFCON_CRCEN|ERXFCON_BCEN;
+  write_rx_filter();
 }
 
 static inline void enc28j60_disable_broadcast ( void ) 
 {
-  writeRegByte(ERXFCON, ERXFCON_UCEN|ERXFCON_CRCEN/*|ERXFCON_PMEN*/);
+  rx_filter = ERXFCON_UCEN|ERXFCON_CRCEN;
+  write_rx_filter();
 }
 
-static u08 enc28j60_init(const u08 macaddr[6], u08 flags)
+static u08 enc28j60_init(const u08 macaddr[6], u08 flags, u08 pages)
 {
   spi_init();
   spi_disable_eth();
@@ -346,6 +411,7 @@ static u08 enc28j60_init(const u08 macaddr[6], u08 flags)
   // soft reset cpu
   writeOp(ENC28J60_SOFT_RESET, 0, ENC28J60_SOFT_RESET);
   _delay_ms(2); // errata B7/2
+  Enc28j60Bank = 0;
   
   // wait or error
   u16 count = 0;
@@ -356,22 +422,45 @@ static u08 enc28j60_init(const u08 macaddr[6], u08 flags)
     }
   }
   
+  // partition buffer memory
+  if(pages < RX_PAGES_MIN) {
+    pages = RX_PAGES_MIN;
+  } else if(pages > RX_PAGES_MAX) {
+    pages = RX_PAGES_MAX;
+  }
+  rx_pages = pages;
+  rx_stop = ((u16)pages << 8) - 1;
+  tx_first = rx_stop + 1;
+  if((TXSTOP_INIT + 1 - tx_first) >= 2 * TXSLOT_SIZE) {
+    tx_second = tx_first + TXSLOT_SIZE;
+  } else {
+    tx_second = tx_first;
+  }
+  tx_slot = tx_first;
+  rx_max_pages = 0;
+  rx_max_pkts = 0;
+
   // set packet pointers
   gNextPacketPtr = RXSTART_INIT;
+  rd_ptr = RD_PTR_UNKNOWN;
+  rx_rel_ptr = RXSTART_INIT;
   writeReg(ERXST, RXSTART_INIT);
   writeReg(ERXRDPT, RXSTART_INIT);
-  writeReg(ERXND, RXSTOP_INIT);
-  writeReg(ETXST, TXSTART_INIT);
+  writeReg(ERXND, rx_stop);
+  writeReg(ETXST, tx_first);
+  tx_start = tx_first;
   writeReg(ETXND, TXSTOP_INIT);
   
   // set packet filter
+  rx_pattern = 0;
+  rx_mcast = 0;
   if(flags & PIO_INIT_BROAD_CAST) {
     enc28j60_enable_broadcast(); // change to add ERXFCON_BCEN recommended by epam
   } else {
     enc28j60_disable_broadcast(); // change to add ERXFCON_BCEN recommended by epam      
   }
 
-  // BIST pattern generator?
+  // pattern: ARP broadcasts. only active with PMEN (see enc28j60_filter)
   writeReg(EPMM0, 0x303f);
   writeReg(EPMCS, 0xf7f9);
   
@@ -421,6 +510,12 @@ static u08 enc28j60_init(const u08 macaddr[6], u08 flags)
   writeRegByte(MAADR1, macaddr[4]);
   writeRegByte(MAADR0, macaddr[5]);
   
+#ifdef USE_INT_PIN
+  // /INT: input with pull-up
+  ETH_INT_DDR &= ~ETH_INT_MASK;
+  ETH_INT_PORT |= ETH_INT_MASK;
+#endif
+
   SetBank(ECON1);
   writeOp(ENC28J60_BIT_FIELD_SET, EIE, EIE_INTIE|EIE_PKTIE);
   writeOp(ENC28J60_BIT_FIELD_SET, ECON1, ECON1_RXEN);
@@ -452,6 +547,10 @@ static u08 enc28j60_control(u08 control_id, u08 value)
         writeRegByte(EFLOCON, flag);
         return PIO_OK;
       }
+    case PIO_CONTROL_RX_RESET:
+      rx_max_pages = 0;
+      rx_max_pkts = 0;
+      return PIO_OK;
     default:
       return PIO_NOT_FOUND;
   }
@@ -468,6 +567,21 @@ static u08 enc28j60_status(u08 status_id, u08 *value)
     case PIO_STATUS_LINK_UP:
       *value = (readPhyByte(PHSTAT2) >> 2) & 1;
       return PIO_OK;
+    case PIO_STATUS_RX_PAGES:
+      *value = rx_pages;
+      return PIO_OK;
+    case PIO_STATUS_RX_MAX_PAGES:
+      *value = rx_max_pages;
+      return PIO_OK;
+    case PIO_STATUS_RX_MAX_PKTS:
+      *value = rx_max_pkts;
+      return PIO_OK;
+    case PIO_STATUS_RX_SPI_OPS:
+      *value = rx_ops;
+      return PIO_OK;
+    case PIO_STATUS_TX_SPI_OPS:
+      *value = tx_ops;
+      return PIO_OK;
     default:
       *value = 0;
       return PIO_NOT_FOUND;
@@ -490,72 +604,150 @@ static u08 enc28j60_get_status( void )
 
 // ---------- send ----------
 
-static u08 enc28j60_send(const u08 *data, u16 size)
+static void wait_tx_ready(void)
 {
-  // prepare tx buffer write
-  writeReg(EWRPT, TXSTART_INIT);
-  writeOp(ENC28J60_WRITE_BUF_MEM, 0, 0x00);
-  
-  // fill buffer
-  u16 num = size;
-  spi_enable_eth(),
-  spi_out(ENC28J60_WRITE_BUF_MEM);  
-  while(num--) {
-    spi_out(*data++);
-  }
-  spi_disable_eth();
-
-  // wait for tx ready
+  // wait for tx ready: last packet may still be in the tx buffer
   while (readOp(ENC28J60_READ_CTRL_REG, ECON1) & ECON1_TXRTS)
       if (readRegByte(EIR) & EIR_TXERIF) {
           writeOp(ENC28J60_BIT_FIELD_SET, ECON1, ECON1_TXRST);
           writeOp(ENC28J60_BIT_FIELD_CLR, ECON1, ECON1_TXRST);
       }
+}
 
-  // initiate send
-  writeReg(ETXND, TXSTART_INIT+size);
+// transmit the packet in the filled slot and switch to the other one.
+// the upload of the next packet overlaps with this transmit
+static void start_tx(u16 size)
+{
+  // the previous packet in the other slot must be gone
+  wait_tx_ready();
+
+  if(tx_start != tx_slot) {
+    writeReg(ETXST, tx_slot);
+    tx_start = tx_slot;
+  }
+  writeReg(ETXND, tx_slot+size);
   writeOp(ENC28J60_BIT_FIELD_SET, ECON1, ECON1_TXRTS);
+
+  tx_slot = (tx_slot == tx_first) ? tx_second : tx_first;
+}
+
+// with a single slot the last packet may still be on the wire
+static void wait_tx_slot(void)
+{
+  if(tx_second == tx_first) {
+    wait_tx_ready();
+  }
+}
+
+static u08 enc28j60_send(const u08 *data, u16 size)
+{
+  spi_ops = 0;
+
+  // prepare tx buffer write: the slot is free as its last packet was
+  // started before the one in the other slot
+  wait_tx_slot();
+  writeReg(EWRPT, tx_slot);
+  
+  // fill buffer: per packet control byte and data
+  cs_enable();
+  spi_out(ENC28J60_WRITE_BUF_MEM);  
+  spi_out(0x00);
+  spi_out_block(data, size);
+  spi_disable_eth();
+
+  // initiate send
+  start_tx(size);
+  tx_ops = spi_ops;
   return PIO_OK;
 }
 
 // ---------- recv ----------
 
-inline static void next_pkt(void)
+// free the rx buffer up to the next packet
+static void release_rx(void)
 {
-  if (gNextPacketPtr - 1 > RXSTOP_INIT)
-      writeReg(ERXRDPT, RXSTOP_INIT);
+  if (gNextPacketPtr - 1 > rx_stop)
+      writeReg(ERXRDPT, rx_stop);
   else
       writeReg(ERXRDPT, gNextPacketPtr - 1);
+  rx_rel_ptr = gNextPacketPtr;
+}
+
+// rx bytes already read but not yet freed
+static u16 rx_held(void)
+{
+  if(gNextPacketPtr >= rx_rel_ptr) {
+    return gNextPacketPtr - rx_rel_ptr;
+  } else {
+    return gNextPacketPtr + rx_stop + 1 - rx_rel_ptr;
+  }
+}
+
+// PKTDEC at once but ERXRDPT only if a part of the ring is held back. a
+// fixed count of packets or bytes would keep too much of a small ring
+inline static void next_pkt(void)
+{
   writeOp(ENC28J60_BIT_FIELD_SET, ECON2, ECON2_PKTDEC);  
+  if(rx_held() > RX_RELEASE_BYTES) {
+    release_rx();
+  }
 }
 
-static u08 read_hdr(u16 *got_size)
+// track rx buffer use: all space from the oldest unreleased byte up to
+// the chip's write pointer
+static void update_rx_level(void)
+{
+  u16 wr = readReg(ERXWRPT);
+  u16 start = rx_rel_ptr;
+  u16 used = (wr >= start) ? (wr - start) : (wr + rx_stop + 1 - start);
+  u08 pages = (used + 255) >> 8;
+  if(pages > rx_max_pages) {
+    rx_max_pages = pages;
+  }
+}
+
+// start a buffer read at the next packet and fetch its header. the read
+// stays open so the data follows in the same transaction. ERDPT is only
+// written if the last read did not stop right at this packet
+static u08 open_pkt(u16 *got_size)
 {
   struct {
       uint16_t nextPacket;
       uint16_t byteCount;
       uint16_t status;
   } header;
-  
-  readBuf(sizeof header, (uint8_t*) &header);
+
+  if(rd_ptr != gNextPacketPtr) {
+    writeReg(ERDPT, gNextPacketPtr);
+  }
+  cs_enable();
+  spi_out(ENC28J60_READ_BUF_MEM);
+  spi_in_block((uint8_t*) &header, sizeof header);
 
   gNextPacketPtr  = header.nextPacket;
   *got_size = header.byteCount - 4; //remove the CRC count
   return header.status;
 }
 
+// end the buffer read after len data bytes of the packet at start.
+// ERDPT wraps at the end of the rx buffer like the data does
+static void close_pkt(u16 start, u16 len)
+{
+  spi_disable_eth();
+  u16 ptr = start + 6 + len;
+  if(ptr > rx_stop) {
+    ptr -= rx_stop + 1;
+  }
+  rd_ptr = ptr;
+}
+
 static u08 enc28j60_recv(u08 *data, u16 max_size, u16 *got_size)
 {
-  writeReg(ERDPT, gNextPacketPtr);
+  spi_ops = 0;
+  u16 start = gNextPacketPtr;
 
   // read chip's packet header
-  u08 status = read_hdr(got_size);
-
-  // was a receive error?
-  if ((status & 0x80)==0) {
-    next_pkt();
-    return PIO_IO_ERR;
-  }
+  u08 status = open_pkt(got_size);
 
   // check size
   u16 len = *got_size;
@@ -565,18 +757,267 @@ static u08 enc28j60_recv(u08 *data, u16 max_size, u16 *got_size)
     result = PIO_TOO_LARGE;
   }
 
+  // was a receive error?
+  if ((status & 0x80)==0) {
+    len = 0;
+    result = PIO_IO_ERR;
+  }
+
   // read packet
-  readBuf(len, data);
+  spi_in_block(data, len);
+
+  // clock past CRC and pad byte so the read ends at the next packet
+  if(result == PIO_OK) {
+    u08 skip = 4 + (len & 1);
+    len += skip;
+    while(skip--) {
+      spi_in();
+    }
+  }
 
+  close_pkt(start, len);
   next_pkt();
+  rx_ops = spi_ops;
   return result;
 }
 
+// ---------- drop ----------
+
+static void enc28j60_drop(void)
+{
+  u16 start = gNextPacketPtr;
+
+  // only the header is read to find the next packet
+  u16 size;
+  open_pkt(&size);
+  close_pkt(start, 0);
+  next_pkt();
+}
+
+// ---------- bench ----------
+
+// move size bytes between buf and the next tx slot without sending
+static void enc28j60_bench(u08 *buf, u16 size, u08 write)
+{
+  wait_tx_slot();
+  if(write) {
+    writeReg(EWRPT, tx_slot);
+    cs_enable();
+    spi_out(ENC28J60_WRITE_BUF_MEM);
+    spi_out_block(buf, size);
+    spi_disable_eth();
+  } else {
+    writeReg(ERDPT, tx_slot);
+    readBuf(size, buf);
+    rd_ptr = RD_PTR_UNKNOWN;
+  }
+}
+
+// ---------- cut-through recv ----------
+
+static u08 enc28j60_recv_begin(u16 *got_size)
+{
+  spi_ops = 0;
+  u16 start = gNextPacketPtr;
+
+  // read chip's packet header
+  u08 status = open_pkt(got_size);
+
+  // was a receive error?
+  if ((status & 0x80)==0) {
+    close_pkt(start, 0);
+    next_pkt();
+    return PIO_IO_ERR;
+  }
+
+  // leave buffer read open: caller clocks in the data with spi_in()
+  return PIO_OK;
+}
+
+static void enc28j60_recv_end(void)
+{
+  // the caller may have stopped early: ERDPT is unknown
+  spi_disable_eth();
+  rd_ptr = RD_PTR_UNKNOWN;
+  next_pkt();
+  rx_ops = spi_ops;
+}
+
+
+// ---------- cut-through send ----------
+
+static void enc28j60_send_begin(void)
+{
+  spi_ops = 0;
+  wait_tx_slot();
+  writeReg(EWRPT, tx_slot);
+
+  // leave buffer write open: caller clocks out the data with spi_out_start()
+  cs_enable();
+  spi_out(ENC28J60_WRITE_BUF_MEM);
+  spi_out(0x00); // per packet control byte
+}
+
+static void enc28j60_send_end(u16 size)
+{
+  // last byte must leave before CS is released
+  spi_out_finish();
+  spi_disable_eth();
+
+  if(size > 0) {
+    start_tx(size);
+  }
+  tx_ops = spi_ops;
+}
+
+// ---------- peek ----------
+
+static u08 enc28j60_peek(u08 *data, u16 max_size, u16 *got_size)
+{
+  // read chip's packet header but keep the read pointer of the packet
+  u16 start = gNextPacketPtr;
+  u08 status = open_pkt(got_size);
+  gNextPacketPtr = start;
+
+  // broken packet is dropped by the next recv
+  u16 len = *got_size;
+  u08 result = PIO_OK;
+  if ((status & 0x80)==0) {
+    len = 0;
+    result = PIO_IO_ERR;
+  }
+  else if(len > max_size) {
+    len = max_size;
+  }
+  spi_in_block(data, len);
+  close_pkt(start, len);
+
+  return result;
+}
+
+// ---------- filter ----------
+
+// one's complement checksum of the pattern bytes selected in EPMM:
+// the broadcast mac (3 words 0xffff) followed by the type bytes
+static u16 pattern_csum(u16 type_word)
+{
+  u32 sum = 3 * 0xffffUL + type_word;
+  while(sum >> 16) {
+    sum = (sum & 0xffff) + (sum >> 16);
+  }
+  return ~(u16)sum;
+}
+
+static void enc28j60_filter(const u16 *types, u08 num)
+{
+  // the chip matches a single pattern only: the broadcast mac plus the
+  // type if all are equal or else the type byte they share (e.g. 0x08 for
+  // IPv4 and ARP). other sets keep all broadcasts.
+  u08 same_hi = 1;
+  u08 same = 1;
+  for(u08 i=1;i<num;i++) {
+    if((types[i] >> 8) != (types[0] >> 8)) {
+      same_hi = 0;
+    }
+    if(types[i] != types[0]) {
+      same = 0;
+    }
+  }
+  rx_pattern = (num != 0) && same_hi && (rx_filter & ERXFCON_BCEN);
+  if(!rx_pattern) {
+    write_rx_filter();
+    return;
+  }
+
+  // select bytes 0-5 (dst mac) and 12 (+13) (type)
+  u08 mask = same ? 0x30 : 0x10;
+  u16 word = same ? types[0] : (types[0] & 0xff00);
+  writeReg(EPMM0, (mask << 8) | 0x3f);
+  writeReg(EPMM2, 0);
+  writeReg(EPMM4, 0);
+  writeReg(EPMM6, 0);
+  writeReg(EPMCS, pattern_csum(word));
+  writeReg(EPMO, 0);
+
+  // unicasts to us OR matching broadcasts
+  write_rx_filter();
+}
+
+// hash table index of a mac: bits 28:23 of its CRC-32 (msb first, data
+// lsb first, no final inversion) as in the datasheet
+static u08 hash_index(const u08 *mac)
+{
+  u32 crc = 0xffffffffUL;
+  for(u08 i=0;i<6;i++) {
+    u08 data = mac[i];
+    for(u08 j=0;j<8;j++) {
+      u08 bit = ((crc >> 31) ^ data) & 1;
+      crc <<= 1;
+      if(bit) {
+        crc ^= 0x04c11db7UL;
+      }
+      data >>= 1;
+    }
+  }
+  return (crc >> 23) & 0x3f;
+}
+
+static void enc28j60_mcast(const u08 *macs, u08 num)
+{
+  // all groups: MCEN. the hash would also pass foreign unicasts
+  if(num == PIO_MCAST_ALL) {
+    rx_mcast = ERXFCON_MCEN;
+  }
+  else if(num == 0) {
+    rx_mcast = 0;
+  }
+  else {
+    u08 hash[8] = { 0,0,0,0,0,0,0,0 };
+    for(u08 i=0;i<num;i++) {
+      u08 idx = hash_index(macs + i * 6);
+      hash[idx >> 3] |= 1 << (idx & 7);
+    }
+    for(u08 i=0;i<8;i++) {
+      writeRegByte(EHT0 + i, hash[i]);
+    }
+    rx_mcast = ERXFCON_HTEN;
+  }
+  write_rx_filter();
+}
+
 // ---------- has_recv ----------
 
 static u08 enc28j60_has_recv(void)
 {
-  return readRegByte(EPKTCNT);
+#ifdef USE_INT_PIN
+  // with PKTIE /INT is low as long as EPKTCNT is not 0. if it is high
+  // and the last read found nothing, only read EPKTCNT once per 10ms tick
+  // in case the line is not wired
+  if((ETH_INT_PIN & ETH_INT_MASK) && (last_pkts == 0)) {
+    u08 t = (u08)timer_10ms;
+    if(t == poll_tick) {
+      return 0;
+    }
+    poll_tick = t;
+  }
+#endif
+  u08 n = readRegByte(EPKTCNT);
+#ifdef USE_INT_PIN
+  last_pkts = n;
+#endif
+  if(n == 0) {
+    // idle: free what was held back
+    if(gNextPacketPtr != rx_rel_ptr) {
+      release_rx();
+    }
+  }
+  // sample the fill level only while the queue is at its deepest so
+  // recv and drop stay free of the extra register read
+  else if(n >= rx_max_pkts) {
+    rx_max_pkts = n;
+    update_rx_level();
+  }
+  return n;
 }
 
 #if 0
@@ -686,5 +1127,14 @@ const pio_dev_t PROGMEM pio_dev_enc28j60 = {
   .recv_f = enc28j60_recv,
   .has_recv_f = enc28j60_has_recv,
   .status_f = enc28j60_status,
-  .control_f = enc28j60_control
+  .control_f = enc28j60_control,
+  .recv_begin_f = enc28j60_recv_begin,
+  .recv_end_f = enc28j60_recv_end,
+  .send_begin_f = enc28j60_send_begin,
+  .send_end_f = enc28j60_send_end,
+  .peek_f = enc28j60_peek,
+  .filter_f = enc28j60_filter,
+  .mcast_f = enc28j60_mcast,
+  .drop_f = enc28j60_drop,
+  .bench_f = enc28j60_bench
 };
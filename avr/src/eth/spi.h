@@ -46,6 +46,25 @@ SPI_SCK  = Digital 13 = PB5
 #define SPI_MISO_MASK	0x10
 #define SPI_SCK_MASK	0x20
 
+/* ENC28J60 /INT (active low)
+
+nano:    Digital 2 = PD2 (wired on the Ethernet Nano shield)
+arduino: Digital 9 = PB1 (extra wire from the module)
+
+*/
+
+#ifdef HAVE_nano
+#define ETH_INT_MASK    0x04
+#define ETH_INT_PORT    PORTD
+#define ETH_INT_PIN     PIND
+#define ETH_INT_DDR     DDRD
+#else
+#define ETH_INT_MASK    0x02
+#define ETH_INT_PORT    PORTB
+#define ETH_INT_PIN     PINB
+#define ETH_INT_DDR     DDRB
+#endif
+
 #else
 
 #ifdef HAVE_avrnetio
@@ -82,6 +101,63 @@ inline u08 spi_in(void)
   return SPDR;
 }
 
+// split transfer: start clocking in a byte now and pick it up later
+inline void spi_in_start(void)
+{
+  SPDR = 0x00;
+}
+
+inline u08 spi_in_finish(void)
+{
+  while (!(SPSR&(1<<SPIF)));
+  return SPDR;
+}
+
+// split transfer: wait for the previous byte to leave, then start the next one
+inline void spi_out_start(u08 data)
+{
+  while (!(SPSR&(1<<SPIF)));
+  SPDR = data;
+}
+
+inline void spi_out_finish(void)
+{
+  while (!(SPSR&(1<<SPIF)));
+}
+
+// bulk transfers for whole buffers (SPI runs at F_CPU/2, see spi_init).
+// the next byte is started right after SPIF and the store/load of the
+// data and the loop counting run while it is on the wire
+inline void spi_in_block(u08 *data, u16 len)
+{
+  if(len == 0) {
+    return;
+  }
+  SPDR = 0x00;
+  while(--len) {
+    while (!(SPSR&(1<<SPIF)));
+    u08 val = SPDR;
+    SPDR = 0x00;
+    *data++ = val;
+  }
+  while (!(SPSR&(1<<SPIF)));
+  *data = SPDR;
+}
+
+inline void spi_out_block(const u08 *data, u16 len)
+{
+  if(len == 0) {
+    return;
+  }
+  SPDR = *data++;
+  while(--len) {
+    u08 val = *data++;
+    while (!(SPSR&(1<<SPIF)));
+    SPDR = val;
+  }
+  while (!(SPSR&(1<<SPIF)));
+}
+
 inline void spi_enable_eth(void) { PORTB &= ~SPI_SS_MASK; }
 inline void spi_disable_eth(void) { PORTB |= SPI_SS_MASK; }
 
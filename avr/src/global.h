@@ -27,6 +27,7 @@
 #ifndef GLOBAL_H
 #define GLOBAL_H
 
+#ifndef __ASSEMBLER__
 typedef unsigned char  u08;
 typedef   signed char  s08;
 typedef unsigned short u16;
@@ -35,6 +36,7 @@ typedef unsigned long  u32;
 typedef   signed long  s32;
 typedef unsigned long long u64;
 typedef   signed long long s64;
+#endif
 
 // project/system dependent defines
 
@@ -43,14 +43,19 @@
 #define ETH_TYPE_MAGIC_ONLINE	0xffff
 #define ETH_TYPE_MAGIC_OFFLINE  0xfffe
 #define ETH_TYPE_MAGIC_LOOPBACK 0xfffd
-
-#define ETH_TYPE_MAGIC_LOOPBACK 0XFFFD
+#define ETH_TYPE_MAGIC_CAPS     0xfffc
+#define ETH_TYPE_MAGIC_CALIB    0xfffb
+#define ETH_TYPE_MAGIC_FILTER   0xfffa
+#define ETH_TYPE_MAGIC_MCAST    0xfff9
+// eth types from here on are reserved for own magic
+#define ETH_TYPE_MAGIC_FIRST    0xfff0
 
 inline const u08* eth_get_tgt_mac(const u08 *pkt) { return pkt + ETH_OFF_TGT_MAC; }
 inline const u08 *eth_get_src_mac(const u08 *pkt) { return pkt + ETH_OFF_SRC_MAC; }
 inline u16 eth_get_pkt_type(const u08 *pkt) { return net_get_word(pkt + ETH_OFF_TYPE); }
 inline u08 eth_is_arp_pkt(const u08 *pkt) { return eth_get_pkt_type(pkt) == ETH_TYPE_ARP; }
 inline u08  eth_is_ipv4_pkt(const u08 *pkt) { return eth_get_pkt_type(pkt) == ETH_TYPE_IPV4; }  
+inline u08 eth_is_magic_type(u16 type) { return type >= ETH_TYPE_MAGIC_FIRST; }
 inline void eth_set_pkt_type(u08 *pkt, u16 type) { net_put_word(pkt + ETH_OFF_TYPE, type); }
 
 inline void eth_make_bcast(u08 *pkt, const u08 *my_mac) 
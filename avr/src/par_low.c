@@ -33,6 +33,8 @@ void par_low_init(void)
   // /STROBE (IN)
   PAR_STROBE_DDR &= ~PAR_STROBE_MASK;
   PAR_STROBE_PORT |= PAR_STROBE_MASK;
+  // latch falling edge of /STROBE
+  PAR_STROBE_ISC_REG = (PAR_STROBE_ISC_REG & ~PAR_STROBE_ISC_MASK) | PAR_STROBE_ISC_FALL;
   
   // SELECT (IN)
   PAR_SELECT_DDR &= ~PAR_SELECT_MASK;
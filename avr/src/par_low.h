@@ -65,6 +65,12 @@
 #define PAR_STROBE_PORT         PORTD
 #define PAR_STROBE_PIN          PIND
 #define PAR_STROBE_DDR          DDRD
+// /STROBE falling edge flag (INT1)
+#define PAR_STROBE_FLAG_REG     EIFR
+#define PAR_STROBE_FLAG_MASK    _BV(INTF1)
+#define PAR_STROBE_ISC_REG      EICRA
+#define PAR_STROBE_ISC_MASK     (_BV(ISC11) | _BV(ISC10))
+#define PAR_STROBE_ISC_FALL     _BV(ISC11)
 #else
 // /STROBE (IN) (INT0) (D2)
 #define PAR_STROBE_BIT          2
@@ -72,6 +78,12 @@
 #define PAR_STROBE_PORT         PORTD
 #define PAR_STROBE_PIN          PIND
 #define PAR_STROBE_DDR          DDRD
+// /STROBE falling edge flag (INT0)
+#define PAR_STROBE_FLAG_REG     EIFR
+#define PAR_STROBE_FLAG_MASK    _BV(INTF0)
+#define PAR_STROBE_ISC_REG      EICRA
+#define PAR_STROBE_ISC_MASK     (_BV(ISC01) | _BV(ISC00))
+#define PAR_STROBE_ISC_FALL     _BV(ISC01)
 #endif
 
 #ifdef HAVE_nano
@@ -137,6 +149,12 @@
 #define PAR_STROBE_PORT         PORTD
 #define PAR_STROBE_PIN          PIND
 #define PAR_STROBE_DDR          DDRD
+// /STROBE falling edge flag (INT0)
+#define PAR_STROBE_FLAG_REG     GIFR
+#define PAR_STROBE_FLAG_MASK    _BV(INTF0)
+#define PAR_STROBE_ISC_REG      MCUCR
+#define PAR_STROBE_ISC_MASK     (_BV(ISC01) | _BV(ISC00))
+#define PAR_STROBE_ISC_FALL     _BV(ISC01)
 
 // SELECT (IN) (INT1)
 #define PAR_SELECT_BIT          3
@@ -177,6 +195,8 @@
 #define PAR_IN_BUF_SIZE     (1 << PAR_IN_BUF_BITS)
 #define PAR_IN_BUF_MASK     (PAR_IN_BUF_SIZE - 1)
 
+#ifndef __ASSEMBLER__
+
 // ----- Functions -----
 
 extern void par_low_init(void);
@@ -248,6 +268,19 @@ inline u08 par_low_get_strobe(void)
   return (PAR_STROBE_PIN & PAR_STROBE_MASK) == PAR_STROBE_MASK;
 }
 
+// the CIA pulses /STROBE on every access of the data port. the falling
+// edge is latched in the external interrupt flag (irq stays disabled)
+
+inline void par_low_strobe_clear(void)
+{
+  PAR_STROBE_FLAG_REG = PAR_STROBE_FLAG_MASK;
+}
+
+inline u08 par_low_strobe_edge(void)
+{
+  return PAR_STROBE_FLAG_REG & PAR_STROBE_FLAG_MASK;
+}
+
 // SELECT (IN)
 
 inline u08 par_low_get_select(void)
@@ -262,4 +295,6 @@ inline u08 par_low_get_pout(void)
   return (PAR_POUT_PIN & PAR_POUT_MASK) == PAR_POUT_MASK;
 }
 
-#endif
\ No newline at end of file
+#endif /* __ASSEMBLER__ */
+
+#endif
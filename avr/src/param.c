@@ -47,6 +47,9 @@ static const param_t PROGMEM default_param = {
 
   .flow_ctl = 0,
   .full_duplex = 0,
+  .cut_through = 1,
+  .arp_offload = 1,
+  .rx_pages = 0x14,
   
   .test_plen = 1514,
   .test_ptype = 0xfffd,
@@ -81,6 +84,9 @@ void param_dump(void)
   uart_send_crlf();
   dump_byte(PSTR("fd: full duplex  "), param.full_duplex);
   dump_byte(PSTR("fc: flow control "), param.flow_ctl);
+  dump_byte(PSTR("ct: cut-through  "), param.cut_through);
+  dump_byte(PSTR("ao: arp offload  "), param.arp_offload);
+  dump_byte(PSTR("er: eth rx pages "), param.rx_pages);
   
   // test
   uart_send_crlf();
@@ -91,6 +97,58 @@ void param_dump(void)
   uart_send_crlf();
   dump_word(PSTR("tp: udp port     "), param.test_port);
   dump_byte(PSTR("tm: test mode    "), param.test_mode);
+
+  // calibrated recv delays
+  uart_send_crlf();
+  for(u08 i=0;i<PARAM_CALIB_NUM;i++) {
+    const param_calib_t *c = &param.calib[i];
+    if(c->delay != 0) {
+      uart_send_pstring(PSTR("calib delay      "));
+      net_dump_mac(c->mac);
+      uart_send_spc();
+      uart_send_hex_byte(c->delay);
+      uart_send_crlf();
+    }
+  }
+}
+
+u08 param_calib_get(const u08 *mac)
+{
+  for(u08 i=0;i<PARAM_CALIB_NUM;i++) {
+    const param_calib_t *c = &param.calib[i];
+    if((c->delay != 0) && (memcmp(c->mac, mac, 6) == 0)) {
+      return c->delay;
+    }
+  }
+  return 0;
+}
+
+void param_calib_set(const u08 *mac, u08 delay)
+{
+  // update existing entry
+  for(u08 i=0;i<PARAM_CALIB_NUM;i++) {
+    param_calib_t *c = &param.calib[i];
+    if((c->delay != 0) && (memcmp(c->mac, mac, 6) == 0)) {
+      c->delay = delay;
+      return;
+    }
+  }
+
+  // replace oldest entry
+  u08 n = param.calib_next;
+  if(n >= PARAM_CALIB_NUM) {
+    n = 0;
+  }
+  param_calib_t *c = &param.calib[n];
+  memcpy(c->mac, mac, 6);
+  c->delay = delay;
+  param.calib_next = n + 1;
+}
+
+void param_calib_clear(void)
+{
+  memset(param.calib, 0, sizeof(param.calib));
+  param.calib_next = 0;
 }
 
 // build check sum for parameter block
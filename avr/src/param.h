@@ -29,17 +29,31 @@
 
 #include "global.h"
 
+// number of Amigas (macs) with a calibrated recv delay
+#define PARAM_CALIB_NUM   4
+
+typedef struct {
+  u08 mac[6];
+  u08 delay;    // 0 = unused entry
+} param_calib_t;
+
 typedef struct {
   u08 mac_addr[6];
 
   u08 flow_ctl;
   u08 full_duplex;
+  u08 cut_through;
+  u08 arp_offload;
+  u08 rx_pages;
 
   u16 test_plen;
   u16 test_ptype;
   u08 test_ip[4];
   u16 test_port;
   u08 test_mode;
+
+  param_calib_t calib[PARAM_CALIB_NUM];
+  u08 calib_next;
 } param_t;
   
 extern param_t param;  
@@ -60,4 +74,11 @@ void param_reset(void);
 // show params
 void param_dump(void);
 
+// return calibrated recv delay for given mac or 0 if unknown
+u08 param_calib_get(const u08 *mac);
+// store recv delay for mac (replaces oldest entry). call param_save() to keep it
+void param_calib_set(const u08 *mac, u08 delay);
+// forget all calibrated recv delays. call param_save() to keep it
+void param_calib_clear(void);
+
 #endif
@@ -0,0 +1,47 @@
+/*
+ * pb_burst.h - hand-scheduled burst data loops (see pb_burst.S)
+ *
+ * Written by
+ *  Christian Vogelgsang <chris@vogelgsang.org>
+ *
+ * This file is part of plipbox.
+ * See README for copyright notice.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+ *  02111-1307  USA.
+ *
+ */
+
+#ifndef PB_BURST_H
+#define PB_BURST_H
+
+#include "global.h"
+
+/* all loops run with irqs disabled and return the number of words
+   transferred. less than words means SELECT was lost.
+   they behave exactly like the C loops in pb_proto.c without crc and
+   streaming. the strobe loops also trigger the burst with RAK.
+*/
+
+// amiga -> buffer: REQ toggles clock the bytes
+extern u16 pb_burst_send(u08 *ptr, u16 words);
+// buffer -> amiga: REQ toggles clock the bytes, delay in 3 cycle units
+extern u16 pb_burst_recv(const u08 *ptr, u16 words, u08 delay);
+// amiga -> buffer: /STROBE pulses clock the bytes
+extern u16 pb_burst_strobe_send(u08 *ptr, u16 words);
+// buffer -> amiga: /STROBE pulses clock the bytes
+extern u16 pb_burst_strobe_recv(const u08 *ptr, u16 words);
+
+#endif
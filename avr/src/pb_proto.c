@@ -26,11 +26,17 @@
 
 #include <avr/interrupt.h>
 #include <util/delay_basic.h>
+#include <util/crc16.h>
 
 #include "pb_proto.h"
 #include "par_low.h"
 #include "timer.h"
 #include "stats.h"
+#include "pio.h"
+#include "spi.h"
+#ifdef PB_ASM
+#include "pb_burst.h"
+#endif
 
 #include "uartutil.h"
 
@@ -47,7 +53,17 @@ static u08 *pb_buf;
 static u16 pb_buf_size;
 static u32 trigger_ts;
 
+// handshake transfer state (see below)
+#define HS_IDLE         0
+#define HS_XFER         1   // REQ edges of size and data
+#define HS_END          2   // wait for SEL == 0
+
+static u08 hs_state = HS_IDLE;
+static u08 req_deferred;    // recv request while transfer was paused
+
 u16 pb_proto_timeout = 5000; // = 500ms in 100us ticks
+u08 pb_proto_send_stream = 0;
+u08 pb_proto_recv_delay = PBPROTO_RECV_DELAY_DEFAULT;
 
 // public stat func
 pb_proto_stat_t pb_proto_stat;
@@ -60,6 +76,10 @@ void pb_proto_init(pb_proto_fill_func ff, pb_proto_proc_func pf, u08 *buf, u16 b
   proc_func = pf;
   pb_buf = buf;
   pb_buf_size = buf_size;
+  pb_proto_send_stream = 0;
+  pb_proto_recv_delay = PBPROTO_RECV_DELAY_DEFAULT;
+  hs_state = HS_IDLE;
+  req_deferred = 0;
 
   // init signals
   par_low_data_set_input();
@@ -86,10 +106,20 @@ u08 pb_proto_get_line_status(void)
 
 void pb_proto_request_recv(void)
 {
+  // do not interrupt a paused transfer: request after it
+  if(hs_state != HS_IDLE) {
+    req_deferred = 1;
+    return;
+  }
   par_low_pulse_ack(1);
   trigger_ts = time_stamp;
 }
 
+u08 pb_proto_busy(void)
+{
+  return hs_state != HS_IDLE;
+}
+
 // ----- HELPER -----
 
 static u08 wait_req(u08 toggle_expect, u08 state_flag)
@@ -121,142 +151,327 @@ static u08 wait_sel(u08 select_state, u08 state_flag)
   return PBPROTO_STATUS_TIMEOUT | state_flag;
 }
 
-// ---------- Handler ----------
+// ---------- Handshake ----------
+
+// SEND and RECV move every byte with a REQ/RAK handshake. they run as a
+// resumable state machine: if the amiga pauses longer than HS_SLICE then
+// pb_proto_handle() returns PBPROTO_STATUS_BUSY and the caller may service
+// the PIO before the next call resumes the transfer. the PIO is not kept
+// open meanwhile: both commands use the buffer and no cut-through.
+
+#define HS_SLICE        2   // busy wait for the next edge (in 100us)
+
+static u08 hs_result;
+static u08 hs_yield;        // transfer was paused at least once
+static u16 hs_edge;         // REQ edges done
+static u16 hs_edges;        // total REQ edges of transfer
+static u16 hs_size;         // packet size
+static u16 hs_bytes;        // data bytes of transfer (even)
+static u08 *hs_ptr;
+static u32 hs_edge_ts;      // time stamp of last edge for timeout
+
+// command state kept for cmd_done() and while a transfer is paused
+static u08 cur_cmd;
+static u08 cur_stream;
+static u08 cur_is_send;
+static u08 cur_is_multi;
+static u32 cur_ts;
+
+static u08 cmd_done(u08 result, u16 ret_size);
 
-// amiga wants to send a packet
-static u08 cmd_send(u16 *ret_size)
+// edges: size hi, size lo, data bytes (recv: a final edge)
+static void hs_start(u16 size)
 {
-  u08 hi, lo;
-  u08 status;
-   
-  // --- get size hi ---
-  status = wait_req(1, PBPROTO_STAGE_SIZE_HI);
-  if(status != PBPROTO_STATUS_OK) {
-    return status;
-  }
-  hi = par_low_data_in();
-  CLR_RAK();
-   
-  // --- get size lo ---
-  status = wait_req(0, PBPROTO_STAGE_SIZE_LO);
-  if(status != PBPROTO_STATUS_OK) {
-    return status;
+  hs_state = HS_XFER;
+  hs_result = PBPROTO_STATUS_OK;
+  hs_edge = 0;
+  hs_size = size;
+  hs_bytes = 0;
+  hs_ptr = pb_buf;
+  hs_edge_ts = time_stamp;
+  if(cur_is_send) {
+    hs_edges = 2; // data edges follow with the size
+  } else {
+    hs_bytes = (size + 1) & ~1;
+    hs_edges = 3 + hs_bytes; // final edge after data
   }
-  lo = par_low_data_in();
-  SET_RAK();
-   
-  u16 size = hi << 8 | lo;
+}
 
-  // check size
-  if(size > pb_buf_size) {
-    return PBPROTO_STATUS_PACKET_TOO_LARGE;
+static void hs_end(u08 result)
+{
+  hs_result = result;
+  hs_state = HS_END;
+  // [IN]
+  if(!cur_is_send) {
+    par_low_data_set_input();
   }
-  
-  // round to even and convert to words
-  u16 words = size;
-  if(words & 1) {
-    words++;
+}
+
+static u08 hs_stage(void)
+{
+  if(hs_edge == 0) {
+    return PBPROTO_STAGE_SIZE_HI;
+  } else if(hs_edge == 1) {
+    return PBPROTO_STAGE_SIZE_LO;
+  } else if(hs_edge == hs_edges - 1) {
+    return cur_is_send ? PBPROTO_STAGE_DATA : PBPROTO_STAGE_LAST_DATA;
+  } else {
+    return PBPROTO_STAGE_DATA;
   }
-  words >>= 1;
-  
-  // --- data loop ---
-  u16 i;
-  u16 got = 0;
-  u08 *ptr = pb_buf;
-  for(i = 0; i < words; i++) {
-    // -- even byte: 0,2,4,...
-    status = wait_req(1, PBPROTO_STAGE_DATA);
-    if(status != PBPROTO_STATUS_OK) {
-      break;
-    }
-    *(ptr++) = par_low_data_in();
+}
+
+// amiga wants to send a packet: read byte of edge
+static void hs_send_edge(void)
+{
+  u08 d = par_low_data_in();
+  if(hs_edge & 1) {
+    SET_RAK();
+  } else {
     CLR_RAK();
-    got++;
+  }
 
-    // -- odd byte: 1,3,5,...
-    status = wait_req(0, PBPROTO_STAGE_DATA);
-    if(status != PBPROTO_STATUS_OK) {
-      break;
+  if(hs_edge == 0) {
+    hs_size = d << 8;
+  }
+  else if(hs_edge == 1) {
+    hs_size |= d;
+    if(hs_size > pb_buf_size) {
+      hs_end(PBPROTO_STATUS_PACKET_TOO_LARGE);
+      return;
     }
-    *(ptr++) = par_low_data_in();
-    SET_RAK();
-    got++;
+    // round to even
+    hs_bytes = (hs_size + 1) & ~1;
+    hs_edges = 2 + hs_bytes;
+  }
+  else {
+    *(hs_ptr++) = d;
   }
-  
-  *ret_size = got;
-  return status;
 }
 
-// amiga wants to receive a packet
-static u08 cmd_recv(u16 size, u16 *ret_size)
+// amiga wants to receive a packet: set byte of edge
+static void hs_recv_edge(void)
 {
-  // --- set size hi ----
-  u08 status = wait_req(1, PBPROTO_STAGE_SIZE_HI);
-  if(status != PBPROTO_STATUS_OK) {
-    return status;
+  if(hs_edge == 0) {
+    // [OUT]
+    par_low_data_set_output();
+    par_low_data_out((u08)(hs_size >> 8));
+  }
+  else if(hs_edge == 1) {
+    par_low_data_out((u08)(hs_size & 0xff));
+  }
+  else if(hs_edge == hs_edges - 1) {
+    // final edge: nothing to set
+    return;
+  }
+  else {
+    par_low_data_out(*(hs_ptr++));
   }
-  u08 hi = (u08)(size >> 8);
-  
-  // [OUT]
-  par_low_data_set_output();
 
-  par_low_data_out(hi);
-  CLR_RAK();
-  
-  // --- set size lo ---
-  status = wait_req(0, PBPROTO_STAGE_SIZE_LO);
-  if(status != PBPROTO_STATUS_OK) {
-    return status;
+  if(hs_edge & 1) {
+    SET_RAK();
+  } else {
+    CLR_RAK();
   }
-  u08 lo = (u08)(size & 0xff);
-  par_low_data_out(lo);
-  SET_RAK();
-  
-  // get number of words
-  u16 words = size;
-  if(words & 1) {
-    words++;
-  }
-  words >>= 1;
-
-  // --- data ---
-  u16 got = 0;
-  const u08 *ptr = pb_buf;
-  for(u16 i = 0; i < words; i++) {
-    // even bytes 0,2,4,...
-    status = wait_req(1, PBPROTO_STAGE_DATA);
-    if(status != PBPROTO_STATUS_OK) {
+}
+
+// run the transfer until it is done or the amiga pauses
+static u08 hs_run(void)
+{
+  u32 slice_ts = time_stamp;
+
+  while(hs_state == HS_XFER) {
+    // even edges expect REQ == 1, odd ones REQ == 0
+    u08 expect = (hs_edge & 1) ? 0 : 1;
+    u08 req = GET_REQ() ? 1 : 0;
+    if(req != expect) {
+      u32 ts = time_stamp;
+      // during transfer client aborted and removed SEL
+      if(!GET_SELECT()) {
+        hs_end(PBPROTO_STATUS_LOST_SELECT | hs_stage());
+      }
+      else if((ts - hs_edge_ts) >= pb_proto_timeout) {
+        hs_end(PBPROTO_STATUS_TIMEOUT | hs_stage());
+      }
+      else if((ts - slice_ts) >= HS_SLICE) {
+        hs_yield = 1;
+        pb_proto_stat.status = PBPROTO_STATUS_BUSY;
+        return PBPROTO_STATUS_BUSY;
+      }
+      continue;
+    }
+
+    if(cur_is_send) {
+      hs_send_edge();
+    } else {
+      hs_recv_edge();
+    }
+    if(hs_state != HS_XFER) {
       break;
     }
-    par_low_data_out(*(ptr++));
-    CLR_RAK();
-    got++;
+    hs_edge++;
+    if(hs_edge == hs_edges) {
+      hs_end(PBPROTO_STATUS_OK);
+    }
+    hs_edge_ts = slice_ts = time_stamp;
+  }
 
-    // odd bytes 1,3,5,...
-    status = wait_req(0, PBPROTO_STAGE_DATA);
-    if(status != PBPROTO_STATUS_OK) {
+  // wait for SEL == 0
+  while(GET_SELECT()) {
+    u32 ts = time_stamp;
+    if((ts - hs_edge_ts) >= pb_proto_timeout) {
       break;
     }
-    par_low_data_out(*(ptr++));
-    SET_RAK();
-    got++;
+    if((ts - slice_ts) >= HS_SLICE) {
+      hs_yield = 1;
+      pb_proto_stat.status = PBPROTO_STATUS_BUSY;
+      return PBPROTO_STATUS_BUSY;
+    }
   }
-  
-  // final wait
-  if(status == PBPROTO_STATUS_OK) {
-    status = wait_req(1, PBPROTO_STAGE_LAST_DATA);
+
+  hs_state = HS_IDLE;
+  u16 got = (hs_edge > 2) ? (hs_edge - 2) : 0;
+  if(got > hs_bytes) {
+    got = hs_bytes;
   }
-  
-  // [IN]
-  par_low_data_set_input();
-  
-  *ret_size = got;
-  return status;
+  u08 result = cmd_done(hs_result, got);
+
+  if(req_deferred) {
+    req_deferred = 0;
+    pb_proto_request_recv();
+  }
+  return result;
 }
 
 // ---------- BURST ----------
 
-static u08 cmd_send_burst(u16 *ret_size)
+// the burst loops optionally build a CRC-CCITT of the data bytes.
+// it is sent as trailer on the exit sync edges of the burst
+static u16 burst_crc;
+
+#define CRC_UPDATE(d)   if(use_crc) { crc = _crc_ccitt_update(crc, d); }
+
+// burst data loop: bytes into buffer.
+// the C loops without streaming are the reference of pb_burst.S
+static u16 send_burst_loop(u08 *ptr, u16 words, u08 use_crc)
+{
+#ifdef PB_ASM
+  if(!use_crc) {
+    return pb_burst_send(ptr, words);
+  }
+#endif
+  u16 i;
+  u16 crc = 0xffff;
+  u08 d;
+  for(i=0;i<words;i++) {
+    // wait REQ == 1
+    while(!GET_REQ()) {
+      if(!GET_SELECT()) return i;
+    }
+    d = par_low_data_in();
+    *(ptr++) = d;
+    CRC_UPDATE(d)
+    
+    // wait REQ == 0
+    while(GET_REQ()) {
+      if(!GET_SELECT()) return i;
+    }
+    d = par_low_data_in();
+    *(ptr++) = d;
+    CRC_UPDATE(d)
+  }
+  burst_crc = crc;
+  return i;
+}
+
+// burst data loop: bytes into buffer and clocked out to the PIO via SPI
+// (cut-through). the buffer copy is kept for the proc func
+static u16 send_burst_loop_stream(u08 *ptr, u16 words, u08 use_crc)
+{
+  u16 i;
+  u16 crc = 0xffff;
+  u08 d;
+  for(i=0;i<words;i++) {
+    // wait REQ == 1
+    while(!GET_REQ()) {
+      if(!GET_SELECT()) return i;
+    }
+    d = par_low_data_in();
+    spi_out_start(d);
+    *(ptr++) = d;
+    CRC_UPDATE(d)
+    
+    // wait REQ == 0
+    while(GET_REQ()) {
+      if(!GET_SELECT()) return i;
+    }
+    d = par_low_data_in();
+    spi_out_start(d);
+    *(ptr++) = d;
+    CRC_UPDATE(d)
+  }
+  burst_crc = crc;
+  return i;
+}
+
+// strobe data loop: the CIA pulses /STROBE when the amiga writes a byte.
+// no REQ toggles: the pace is given by the CIA access cycle
+static u16 send_strobe_loop(u08 *ptr, u16 words)
+{
+#ifdef PB_ASM
+  return pb_burst_strobe_send(ptr, words);
+#else
+  u16 i;
+  par_low_strobe_clear();
+  SET_RAK(); // trigger start of burst
+  for(i=0;i<words;i++) {
+    // even byte
+    while(!par_low_strobe_edge()) {
+      if(!GET_SELECT()) return i;
+    }
+    par_low_strobe_clear();
+    *(ptr++) = par_low_data_in();
+
+    // odd byte
+    while(!par_low_strobe_edge()) {
+      if(!GET_SELECT()) return i;
+    }
+    par_low_strobe_clear();
+    *(ptr++) = par_low_data_in();
+  }
+  return i;
+#endif
+}
+
+// strobe data loop with cut-through to the PIO
+static u16 send_strobe_loop_stream(u08 *ptr, u16 words)
+{
+  u16 i;
+  u08 d;
+  par_low_strobe_clear();
+  SET_RAK(); // trigger start of burst
+  for(i=0;i<words;i++) {
+    // even byte
+    while(!par_low_strobe_edge()) {
+      if(!GET_SELECT()) return i;
+    }
+    par_low_strobe_clear();
+    d = par_low_data_in();
+    spi_out_start(d);
+    *(ptr++) = d;
+
+    // odd byte
+    while(!par_low_strobe_edge()) {
+      if(!GET_SELECT()) return i;
+    }
+    par_low_strobe_clear();
+    d = par_low_data_in();
+    spi_out_start(d);
+    *(ptr++) = d;
+  }
+  return i;
+}
+
+static u08 cmd_send_burst(u08 stream, u08 strobe, u08 crc, u16 *ret_size)
 {
   u08 hi, lo;
   u08 status;
@@ -284,69 +499,258 @@ static u08 cmd_send_burst(u16 *ret_size)
     return PBPROTO_STATUS_PACKET_TOO_LARGE;
   }
 
+  // empty packet: ends a multi transfer
+  if(size == 0) {
+    SET_RAK();
+    *ret_size = 0;
+    return PBPROTO_STATUS_OK;
+  }
+
   // round to even and convert to words
   u16 words = (size +1) >> 1;
   u16 i;
   u08 result = PBPROTO_STATUS_OK;
-  u08 *ptr = pb_buf;
 
   // ----- burst loop -----
   // BEGIN TIME CRITICAL
   cli();
-  SET_RAK(); // trigger start of burst
-  for(i=0;i<words;i++) {
-    // wait REQ == 1
-    while(!GET_REQ()) {
-      if(!GET_SELECT()) goto send_burst_exit;
+  if(strobe) {
+    if(stream) {
+      i = send_strobe_loop_stream(pb_buf, words);
+    } else {
+      i = send_strobe_loop(pb_buf, words);
     }
-    *(ptr++) = par_low_data_in();
-    
-    // wait REQ == 0
-    while(GET_REQ()) {
-      if(!GET_SELECT()) goto send_burst_exit;
+  } else {
+    SET_RAK(); // trigger start of burst
+    if(stream) {
+      i = send_burst_loop_stream(pb_buf, words, crc);
+    } else {
+      i = send_burst_loop(pb_buf, words, crc);
     }
-    *(ptr++) = par_low_data_in();
   }
-send_burst_exit:
   sei();
   // END TIME CRITICAL
 
+  // error?
+  if(i<words) {
+    result = PBPROTO_STATUS_TIMEOUT | PBPROTO_STAGE_DATA;
+    goto send_burst_exit;
+  }
+
   // wait REQ == 1
   while(!GET_REQ()) {
-    if(!GET_SELECT()) goto send_burst_exit;
+    if(!GET_SELECT()) goto send_burst_lost;
   }
+  u08 crc_hi = par_low_data_in();
 
   CLR_RAK();
 
   // wait REQ == 0
   while(GET_REQ()) {
-    if(!GET_SELECT()) goto send_burst_exit;
-  }
-
-  // error?
-  if(i<words) {
-    result = PBPROTO_STATUS_TIMEOUT | PBPROTO_STAGE_DATA;
+    if(!GET_SELECT()) goto send_burst_lost;
   }
+  u08 crc_lo = par_low_data_in();
 
   // final ACK 
   SET_RAK();
 
+  // check crc trailer
+  if(crc && (burst_crc != (u16)((crc_hi << 8) | crc_lo))) {
+    result = PBPROTO_STATUS_CRC;
+  }
+  goto send_burst_exit;
+
+send_burst_lost:
+  result = PBPROTO_STATUS_LOST_SELECT | PBPROTO_STAGE_LAST_DATA;
+send_burst_exit:
   *ret_size = i << 1;
   return result;  
 }
 
-// delay loop for recv
-#if (F_CPU == 16000000)
+// receive and process frames until the amiga sends an empty one.
+// each frame ends with RAK=1 and REQ=0 just like after the command byte
+static u08 cmd_send_multi(u16 *ret_size)
+{
+  u08 result;
+  u16 total = 0;
+  while(1) {
+    u16 size = 0;
+    u08 stream = pb_proto_send_stream;
+    if(stream) {
+      pio_send_begin();
+    }
+
+    result = cmd_send_burst(stream, 0, 0, &size);
+    if((result == PBPROTO_STATUS_OK) && (size > 0)) {
+      total += size;
+      result = proc_func(pb_buf, size);
+    }
+    // drop broken or empty packet streamed to PIO
+    else if(stream) {
+      pio_send_end(0);
+    }
+
+    if((result != PBPROTO_STATUS_OK) || (size == 0)) {
+      break;
+    }
+  }
+
+  *ret_size = total;
+  return result;
+}
+
+// delay loop for recv: 3 cycles per count
+// the count is kept in a local copy of pb_proto_recv_delay
+#define DELAY _delay_loop_1(delay);
+
+// burst data loop: bytes from buffer
+// the crc is updated while the amiga is still busy with the REQ toggle
+static u16 recv_burst_loop(const u08 *ptr, u16 words, u08 use_crc)
+{
+#ifdef PB_ASM
+  if(!use_crc) {
+    return pb_burst_recv(ptr, words, pb_proto_recv_delay);
+  }
+#endif
+  const u08 delay = pb_proto_recv_delay;
+  u16 i;
+  u16 crc = 0xffff;
+  u08 d;
+  for(i=0;i<words;i++) {
+
+    DELAY
+    d = *(ptr++);
+    par_low_data_out(d);
+    CRC_UPDATE(d)
+
+    // wait REQ == 0
+    while(GET_REQ()) {
+      if(!GET_SELECT()) return i;
+    }
+
+    DELAY
+    d = *(ptr++);
+    par_low_data_out(d);
+    CRC_UPDATE(d)
+
+    // wait REQ == 1
+    while(!GET_REQ()) {
+      if(!GET_SELECT()) return i;
+    }
+
+  }
+  burst_crc = crc;
+  return i;
+}
+
+// burst data loop: bytes clocked in from the PIO via SPI (cut-through)
+// the SPI transfer of the next byte runs while we wait for the REQ toggle
+static u16 recv_burst_loop_stream(u16 words, u08 use_crc)
+{
+  const u08 delay = pb_proto_recv_delay;
+  u16 i;
+  u16 crc = 0xffff;
+  u08 d;
+  spi_in_start();
+  for(i=0;i<words;i++) {
+
+    d = spi_in_finish();
+    spi_in_start();
+    DELAY
+    par_low_data_out(d);
+    CRC_UPDATE(d)
+
+    // wait REQ == 0
+    while(GET_REQ()) {
+      if(!GET_SELECT()) goto stream_exit;
+    }
+
+    d = spi_in_finish();
+    spi_in_start();
+    DELAY
+    par_low_data_out(d);
+    CRC_UPDATE(d)
+
+    // wait REQ == 1
+    while(!GET_REQ()) {
+      if(!GET_SELECT()) goto stream_exit;
+    }
 
-// at least 2us
-// 3 cycles per call
-#define DELAY _delay_loop_1(6);
+  }
+stream_exit:
+  burst_crc = crc;
+  // always drain the pending SPI transfer
+  spi_in_finish();
+  return i;
+}
 
+// strobe data loop: the CIA pulses /STROBE when the amiga reads a byte.
+// then the next one is put on the port
+static u16 recv_strobe_loop(const u08 *ptr, u16 words)
+{
+#ifdef PB_ASM
+  return pb_burst_strobe_recv(ptr, words);
 #else
-#error Delay loop not defined for F_CPU
+  u16 i;
+  par_low_data_out(*(ptr++));
+  par_low_strobe_clear();
+  CLR_RAK(); // trigger start of burst
+  for(i=0;i<words;i++) {
+    // even byte was read
+    while(!par_low_strobe_edge()) {
+      if(!GET_SELECT()) return i;
+    }
+    par_low_strobe_clear();
+    par_low_data_out(*(ptr++));
+
+    // odd byte was read
+    while(!par_low_strobe_edge()) {
+      if(!GET_SELECT()) return i;
+    }
+    par_low_strobe_clear();
+    par_low_data_out(*(ptr++));
+  }
+  return i;
 #endif
+}
+
+// strobe data loop: bytes clocked in from the PIO via SPI (cut-through)
+static u16 recv_strobe_loop_stream(u16 words)
+{
+  u16 i;
+  spi_in_start();
+  par_low_data_out(spi_in_finish());
+  spi_in_start();
+  par_low_strobe_clear();
+  CLR_RAK(); // trigger start of burst
+  for(i=0;i<words;i++) {
+    // even byte was read
+    while(!par_low_strobe_edge()) {
+      if(!GET_SELECT()) goto stream_exit;
+    }
+    par_low_strobe_clear();
+    par_low_data_out(spi_in_finish());
+    spi_in_start();
+
+    // odd byte was read
+    while(!par_low_strobe_edge()) {
+      if(!GET_SELECT()) goto stream_exit;
+    }
+    par_low_strobe_clear();
+    par_low_data_out(spi_in_finish());
+    spi_in_start();
+  }
+stream_exit:
+  // always drain the pending SPI transfer
+  spi_in_finish();
+  return i;
+}
 
-static u08 cmd_recv_burst(u16 size, u16 *ret_size)
+// transfer a single frame: size and burst data.
+// returns without the final ACK (RAK=1 and REQ=1 on success). in a multi
+// transfer the size hi of the next frame acknowledges the last one.
+// with crc the trailer is output on the exit sync and the final ACK
+static u08 recv_burst_frame(u16 size, u08 stream, u08 strobe, u08 crc, u16 *ret_size)
 {
   u08 hi, lo;
   u08 status;
@@ -371,6 +775,12 @@ static u08 cmd_recv_burst(u16 size, u16 *ret_size)
   par_low_data_out(lo);
   SET_RAK();
 
+  // empty packet: amiga leaves right after size
+  if(size == 0) {
+    *ret_size = 0;
+    return PBPROTO_STATUS_OK;
+  }
+
   // --- burst ready? ---
   status = wait_req(1, PBPROTO_STAGE_DATA);
   if(status != PBPROTO_STATUS_OK) {
@@ -381,62 +791,168 @@ static u08 cmd_recv_burst(u16 size, u16 *ret_size)
   u16 words = (size + 1) >> 1;
   u08 result = PBPROTO_STATUS_OK;
   u16 i;
-  u08 *ptr = pb_buf;
 
   // ----- burst loop -----
   // BEGIN TIME CRITICAL
   cli();
-  // prepare first byte
-  CLR_RAK(); // trigger start of burst
-  // loop
-  for(i=0;i<words;i++) {
-
-    DELAY
-    par_low_data_out(*(ptr++));      
-
-    // wait REQ == 0
-    while(GET_REQ()) {
-      if(!GET_SELECT()) goto recv_burst_exit;
+  if(strobe) {
+    if(stream) {
+      i = recv_strobe_loop_stream(words);
+    } else {
+      i = recv_strobe_loop(pb_buf, words);
     }
-
-    DELAY
-    par_low_data_out(*(ptr++));
-
-    // wait REQ == 1
-    while(!GET_REQ()) {
-      if(!GET_SELECT()) goto recv_burst_exit;
+  } else {
+    CLR_RAK(); // trigger start of burst
+    if(stream) {
+      i = recv_burst_loop_stream(words, crc);
+    } else {
+      i = recv_burst_loop(pb_buf, words, crc);
     }
-
   }
-recv_burst_exit:
   sei();
   // END TIME CRITICAL
 
+  // error?
+  if(i<words) {
+    result = PBPROTO_STATUS_TIMEOUT | PBPROTO_STAGE_DATA;
+    goto recv_burst_exit;
+  }
+
   // final wait REQ == 0
   while(GET_REQ()) {
-    if(!GET_SELECT()) goto recv_burst_exit;
+    if(!GET_SELECT()) goto recv_burst_lost;
   }
 
+  if(crc) {
+    par_low_data_out((u08)(burst_crc >> 8));
+  }
   SET_RAK();
     
   // final wait REQ == 1
   while(!GET_REQ()) {
-    if(!GET_SELECT()) goto recv_burst_exit;
+    if(!GET_SELECT()) goto recv_burst_lost;
   }
-  
-  // error?
-  if(i<words) {
-    result = PBPROTO_STATUS_TIMEOUT | PBPROTO_STAGE_DATA;
+
+  if(crc) {
+    par_low_data_out((u08)(burst_crc & 0xff));
   }
+  goto recv_burst_exit;
+
+recv_burst_lost:
+  result = PBPROTO_STATUS_LOST_SELECT | PBPROTO_STAGE_LAST_DATA;
+recv_burst_exit:
+  *ret_size = i << 1;
+  return result;  
+}
+
+static u08 cmd_recv_burst(u16 size, u08 stream, u08 strobe, u08 crc, u16 *ret_size)
+{
+  u08 result = recv_burst_frame(size, stream, strobe, crc, ret_size);
 
   // final ACK
-  CLR_RAK();
+  if((result == PBPROTO_STATUS_OK) && (size > 0)) {
+    CLR_RAK();
+  }
 
   // [IN]
   par_low_data_set_input();
+  return result;
+}
 
-  *ret_size = i << 1;
-  return result;  
+// send frames with burst until the fill func has no more data or
+// PBPROTO_MULTI_MAX is reached. an empty frame ends the transfer.
+static u08 cmd_recv_multi(u16 size, u08 *stream, u16 *ret_size)
+{
+  u08 result;
+  u08 num = 0;
+  u16 total = 0;
+  while(1) {
+    u16 got = 0;
+    result = recv_burst_frame(size, *stream, 0, 0, &got);
+    total += got;
+
+    // release streamed PIO packet
+    if(*stream) {
+      pio_recv_end();
+      *stream = 0;
+    }
+
+    if((result != PBPROTO_STATUS_OK) || (size == 0)) {
+      break;
+    }
+
+    // fetch next frame
+    num++;
+    size = 0;
+    if(num < PBPROTO_MULTI_MAX) {
+      u08 res = fill_func(pb_buf, pb_buf_size, &size);
+      if(res == PBPROTO_STATUS_STREAM) {
+        *stream = 1;
+      }
+      else if(res != PBPROTO_STATUS_OK) {
+        size = 0;
+      }
+    }
+  }
+
+  // [IN]
+  par_low_data_set_input();
+
+  *ret_size = total;
+  return result;
+}
+
+// finish command: release RAK, process the packet and fill in stats
+static u08 cmd_done(u08 result, u16 ret_size)
+{
+  pb_proto_stat_t *ps = &pb_proto_stat;
+
+  // reset RAK = 0
+  CLR_RAK();
+
+  // read timer. a paused transfer shared the hw timer: use the time stamps
+  u16 delta;
+  if(hs_yield) {
+    u32 d = (time_stamp - cur_ts) * 25; // 100us -> 4us
+    delta = (d > 0xffff) ? 0xffff : (u16)d;
+  } else {
+    delta = timer_hw_get();
+  }
+
+  // release streamed PIO packet
+  if(cur_stream && !cur_is_send) {
+    pio_recv_end();
+  }
+
+  // process buffer for send command (multi: done per frame)
+  if(cur_is_send && !cur_is_multi) {
+    if(result == PBPROTO_STATUS_OK) {
+      // handshake send was buffered: stream it to the PIO now
+      if((cur_cmd == PBPROTO_CMD_SEND) && pb_proto_send_stream) {
+        pio_send_begin();
+        for(u16 i=0;i<ret_size;i++) {
+          spi_out(pb_buf[i]);
+        }
+      }
+      result = proc_func(pb_buf, ret_size);
+    }
+    // drop broken packet streamed to PIO
+    else if(cur_stream) {
+      pio_send_end(0);
+    }
+  } 
+  
+  // fill in stats
+  ps->cmd = cur_cmd;
+  ps->status = result;
+  ps->size = ret_size;
+  ps->delta = delta;
+  ps->rate = timer_hw_calc_rate_kbs(ret_size, delta);
+  ps->ts = cur_ts;
+  ps->is_send = cur_is_send;
+  ps->stats_id = ps->is_send ? STATS_ID_PB_TX : STATS_ID_PB_RX;
+  ps->recv_delta = ps->is_send ? 0 : (u16)(ps->ts - trigger_ts);
+  return result;
 }
 
 u08 pb_proto_handle(void)
@@ -444,6 +960,11 @@ u08 pb_proto_handle(void)
   u08 result;
   pb_proto_stat_t *ps = &pb_proto_stat;
 
+  // resume paused handshake transfer
+  if(hs_state != HS_IDLE) {
+    return hs_run();
+  }
+
   // handle server side of plipbox protocol
   ps->cmd = 0; 
   
@@ -464,65 +985,97 @@ u08 pb_proto_handle(void)
 
   // fill buffer for recv command
   u16 pkt_size = 0;
-  if((cmd == PBPROTO_CMD_RECV) || (cmd == PBPROTO_CMD_RECV_BURST)) {
+  u08 stream = 0;
+  u08 is_send = (cmd == PBPROTO_CMD_SEND) || (cmd == PBPROTO_CMD_SEND_BURST) ||
+                (cmd == PBPROTO_CMD_SEND_MULTI) || (cmd == PBPROTO_CMD_SEND_STROBE) ||
+                (cmd == PBPROTO_CMD_SEND_BURST_CRC);
+  u08 is_multi = (cmd == PBPROTO_CMD_SEND_MULTI);
+  u08 is_hs = (cmd == PBPROTO_CMD_SEND) || (cmd == PBPROTO_CMD_RECV);
+  if((cmd == PBPROTO_CMD_RECV) || (cmd == PBPROTO_CMD_RECV_BURST) ||
+     (cmd == PBPROTO_CMD_RECV_MULTI) || (cmd == PBPROTO_CMD_RECV_STROBE) ||
+     (cmd == PBPROTO_CMD_RECV_BURST_CRC)) {
     u08 res = fill_func(pb_buf, pb_buf_size, &pkt_size);
-    if(res != PBPROTO_STATUS_OK) {
+    if(res == PBPROTO_STATUS_STREAM) {
+      // handshake transfer may pause: copy packet and release the PIO
+      if(is_hs) {
+        if(pkt_size > pb_buf_size) {
+          pio_recv_end();
+          ps->status = PBPROTO_STATUS_PACKET_TOO_LARGE;
+          return PBPROTO_STATUS_PACKET_TOO_LARGE;
+        }
+        for(u16 i=0;i<pkt_size;i++) {
+          pb_buf[i] = spi_in();
+        }
+        pio_recv_end();
+      } else {
+        stream = 1;
+      }
+    }
+    else if(res != PBPROTO_STATUS_OK) {
       ps->status = res;
       return res;
     }
   }
+  // open PIO tx buffer for send command (multi: done per frame)
+  else if(is_send && !is_multi && !is_hs && pb_proto_send_stream) {
+    pio_send_begin();
+    stream = 1;
+  }
 
   // start timer
-  u32 ts = time_stamp;
+  cur_cmd = cmd;
+  cur_is_send = is_send;
+  cur_is_multi = is_multi;
+  cur_ts = time_stamp;
+  hs_yield = 0;
   timer_hw_reset();
 
   // confirm cmd with RAK = 1
   SET_RAK();
 
+  // handshake: run state machine
+  if(is_hs) {
+    cur_stream = 0;
+    hs_start(pkt_size);
+    return hs_run();
+  }
+
   u16 ret_size = 0;
   switch(cmd) {
-    case PBPROTO_CMD_RECV:
-      result = cmd_recv(pkt_size, &ret_size);
-      break;
-    case PBPROTO_CMD_SEND:
-      result = cmd_send(&ret_size);
-      break;
     case PBPROTO_CMD_RECV_BURST:
-      result = cmd_recv_burst(pkt_size, &ret_size);
+      result = cmd_recv_burst(pkt_size, stream, 0, 0, &ret_size);
       break;
     case PBPROTO_CMD_SEND_BURST:
-      result = cmd_send_burst(&ret_size);
+      result = cmd_send_burst(stream, 0, 0, &ret_size);
+      break;
+    // the command says if a trailer follows: no session state that
+    // could differ after a restart of either side
+    case PBPROTO_CMD_RECV_BURST_CRC:
+      result = cmd_recv_burst(pkt_size, stream, 0, 1, &ret_size);
+      break;
+    case PBPROTO_CMD_SEND_BURST_CRC:
+      result = cmd_send_burst(stream, 0, 1, &ret_size);
+      break;
+    case PBPROTO_CMD_RECV_STROBE:
+      result = cmd_recv_burst(pkt_size, stream, 1, 0, &ret_size);
+      break;
+    case PBPROTO_CMD_SEND_STROBE:
+      result = cmd_send_burst(stream, 1, 0, &ret_size);
+      break;
+    case PBPROTO_CMD_RECV_MULTI:
+      result = cmd_recv_multi(pkt_size, &stream, &ret_size);
+      break;
+    case PBPROTO_CMD_SEND_MULTI:
+      result = cmd_send_multi(&ret_size);
       break;
     default:
       result = PBPROTO_STATUS_INVALID_CMD;
       break;
   }
+  cur_stream = stream;
    
   // wait for SEL == 0
   wait_sel(0, PBPROTO_STAGE_END_SELECT);
-  
-  // reset RAK = 0
-  CLR_RAK();
-
-  // read timer
-  u16 delta = timer_hw_get();
 
-  // process buffer for send command
-  if(result == PBPROTO_STATUS_OK) {
-    if((cmd == PBPROTO_CMD_SEND) || (cmd == PBPROTO_CMD_SEND_BURST)) {
-      result = proc_func(pb_buf, ret_size);
-    }
-  } 
-  
-  // fill in stats
-  ps->cmd = cmd;
-  ps->status = result;
-  ps->size = ret_size;
-  ps->delta = delta;
-  ps->rate = timer_hw_calc_rate_kbs(ret_size, delta);
-  ps->ts = ts;
-  ps->is_send = (cmd == PBPROTO_CMD_SEND) || (cmd == PBPROTO_CMD_SEND_BURST);
-  ps->stats_id = ps->is_send ? STATS_ID_PB_TX : STATS_ID_PB_RX;
-  ps->recv_delta = ps->is_send ? 0 : (u16)(ps->ts - trigger_ts);
-  return result;
+  return cmd_done(result, ret_size);
 }
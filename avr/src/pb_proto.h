@@ -37,6 +37,9 @@
 #define PBPROTO_STATUS_INVALID_CMD       4
 #define PBPROTO_STATUS_PACKET_TOO_LARGE  5
 #define PBPROTO_STATUS_ERROR             6
+#define PBPROTO_STATUS_STREAM            7  // fill func: data comes from PIO
+#define PBPROTO_STATUS_CRC               8  // burst crc trailer mismatch
+#define PBPROTO_STATUS_BUSY              9  // transfer paused: call again
 
 // protocol stages for error reprots
 #define PBPROTO_STAGE_END_SELECT         0x10
@@ -53,6 +56,47 @@
 #define PBPROTO_CMD_RECV       0x22   // amiga wants to receive a packet
 #define PBPROTO_CMD_SEND_BURST 0x33
 #define PBPROTO_CMD_RECV_BURST 0x44
+#define PBPROTO_CMD_RECV_MULTI 0x55   // amiga receives several frames in burst
+#define PBPROTO_CMD_SEND_MULTI 0x66   // amiga sends several frames in burst
+#define PBPROTO_CMD_SEND_STROBE 0x77  // burst clocked by CIA /STROBE
+#define PBPROTO_CMD_RECV_STROBE 0x88
+#define PBPROTO_CMD_SEND_BURST_CRC 0x99 // burst with crc trailer
+#define PBPROTO_CMD_RECV_BURST_CRC 0xaa
+
+// max frames in a single RECV_MULTI transfer (SEND_MULTI: set by amiga)
+#define PBPROTO_MULTI_MAX      4
+
+// TLV list (tag, len, value) behind the header of magic packets.
+// the amiga offers its caps in the online magic and we reply with a caps
+// magic holding the ones we agree on
+#define PBPROTO_TLV_END        0
+#define PBPROTO_TLV_VERSION    1      // major, minor
+#define PBPROTO_TLV_CAPS       2      // capability bits below
+#define PBPROTO_TLV_TYPES      3      // eth types read by amiga (words)
+#define PBPROTO_TLV_MCAST      4      // multicast macs (6 bytes each)
+
+// capabilities negotiated with the online magic
+#define PBPROTO_CAP_RECV_MULTI 0x01
+#define PBPROTO_CAP_SEND_MULTI 0x02
+#define PBPROTO_CAP_STROBE     0x04
+#define PBPROTO_CAP_CALIB      0x08   // amiga echoes calibration frames
+#define PBPROTO_CAP_CRC        0x10   // SEND_BURST_CRC/RECV_BURST_CRC
+#define PBPROTO_CAP_BURST      0x20   // SEND_BURST/RECV_BURST
+#define PBPROTO_CAP_FILTER     0x40   // amiga sends its types in filter magic
+#define PBPROTO_CAP_MCAST      0x80   // amiga sends its groups in mcast magic
+#define PBPROTO_CAP_ALL        (PBPROTO_CAP_RECV_MULTI | PBPROTO_CAP_SEND_MULTI | \
+                                PBPROTO_CAP_STROBE | PBPROTO_CAP_CALIB | \
+                                PBPROTO_CAP_CRC | PBPROTO_CAP_BURST | \
+                                PBPROTO_CAP_FILTER | PBPROTO_CAP_MCAST)
+
+// max types in a filter magic. more are sent as an empty list (= all)
+#define PBPROTO_FILTER_MAX     8
+// max macs in a mcast magic. no list means none, an empty list all groups
+#define PBPROTO_MCAST_MAX      16
+
+// default recv burst delay in _delay_loop_1() units (3 cycles each):
+// 6 at 16 MHz (about 1.1us) and scaled with F_CPU
+#define PBPROTO_RECV_DELAY_DEFAULT  (((F_CPU / 1000000UL) * 3 + 7) / 8)
 
 // line status
 #define PBPROTO_LINE_OFF       0x0
@@ -60,6 +104,10 @@
 #define PBPROTO_LINE_OK        0x1
 
 // callbacks
+// fill func returns PBPROTO_STATUS_STREAM if it did not fill the buffer but
+// opened the next PIO packet with pio_recv_begin() (cut-through)
+// with pb_proto_send_stream set the proc func gets a packet that was also
+// streamed into the open PIO tx buffer: it must close it with pio_send_end()
 typedef u08 (*pb_proto_fill_func)(u08 *buf,u16 max_size,u16 *size);
 typedef u08 (*pb_proto_proc_func)(const u08 *buf, u16 size);
 
@@ -70,7 +118,7 @@ typedef struct {
   u08 stats_id; // what id to use for stats recording
   u16 size;     // packet size 
   u16 delta;    // hw timing for transmit
-  u16 rate;     // delta converted to transfer rate
+  u32 rate;     // delta converted to transfer rate
   u16 recv_delta; // delta after recv was requested 
   u32 ts;       // time stamp of transfer
 } pb_proto_stat_t;
@@ -80,12 +128,16 @@ extern pb_proto_stat_t pb_proto_stat; // filled by pb_proto_handle()
 // ----- Parameter -----
 
 extern u16 pb_proto_rx_timeout; // timeout for next byte in 100us
+extern u08 pb_proto_send_stream; // stream amiga packets directly to PIO
+extern u08 pb_proto_recv_delay;  // delay before each recv burst byte
 
 // ----- API -----
 
 extern void pb_proto_init(pb_proto_fill_func fill_func, pb_proto_proc_func proc_func, u08 *buf, u16 buf_size);
 extern u08  pb_proto_get_line_status(void);
 extern u08  pb_proto_handle(void); // side effect: fill pb_proto_stat!
+                                   // BUSY: transfer paused, call again
 extern void pb_proto_request_recv(void);
+extern u08  pb_proto_busy(void);   // paused transfer still owns the buffer
 
 #endif
@@ -158,7 +158,7 @@ static void pb_test_worker(void)
     }
   }
   // pb proto failed with an error
-  else if(status != PBPROTO_STATUS_IDLE) {
+  else if((status != PBPROTO_STATUS_IDLE) && (status != PBPROTO_STATUS_BUSY)) {
     // disable auto mode
     if(auto_mode) {
       pb_test_toggle_auto();
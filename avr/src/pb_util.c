@@ -40,6 +40,10 @@ u08 pb_util_handle(void)
   if(status == PBPROTO_STATUS_IDLE) {
     return PBPROTO_STATUS_IDLE; // inactive
   }
+  // transfer paused: report when done
+  if(status == PBPROTO_STATUS_BUSY) {
+    return PBPROTO_STATUS_BUSY;
+  }
 
   const pb_proto_stat_t *ps = &pb_proto_stat;
 
@@ -58,7 +62,11 @@ u08 pb_util_handle(void)
     // dump error
     dump_pb_cmd(ps);
     // account data
-    stats_get(ps->stats_id)->err++;
+    stats_t *s = stats_get(ps->stats_id);
+    s->err++;
+    if(status == PBPROTO_STATUS_CRC) {
+      s->crc++;
+    }
   }
   return status;
 }
@@ -55,7 +55,7 @@ u08 pio_set_device(u08 id)
   return 0;
 }
 
-u08 pio_init(const u08 mac[6],u08 flags)
+u08 pio_init(const u08 mac[6],u08 flags,u08 rx_pages)
 {
   // get current device
   cur_dev = (pio_dev_ptr_t)pgm_read_word(devices + dev_id);
@@ -67,7 +67,7 @@ u08 pio_init(const u08 mac[6],u08 flags)
   uart_send_pstring(name);
 
   // call init
-  u08 result = pio_dev_init(cur_dev, mac, flags);
+  u08 result = pio_dev_init(cur_dev, mac, flags, rx_pages);
   if(result == PIO_OK) {
     uart_send_pstring(PSTR(": ok! mac="));
     net_dump_mac(mac);
@@ -119,3 +119,48 @@ u08 pio_control(u08 control_id, u08 value)
 {
   return pio_dev_control(cur_dev, control_id, value);
 }
+
+u08 pio_recv_begin(u16 *got_size)
+{
+  return pio_dev_recv_begin(cur_dev, got_size);
+}
+
+void pio_recv_end(void)
+{
+  pio_dev_recv_end(cur_dev);
+}
+
+void pio_send_begin(void)
+{
+  pio_dev_send_begin(cur_dev);
+}
+
+void pio_send_end(u16 size)
+{
+  pio_dev_send_end(cur_dev, size);
+}
+
+u08 pio_peek(u08 *buf, u16 max_size, u16 *got_size)
+{
+  return pio_dev_peek(cur_dev, buf, max_size, got_size);
+}
+
+void pio_drop(void)
+{
+  pio_dev_drop(cur_dev);
+}
+
+void pio_bench(u08 *buf, u16 size, u08 write)
+{
+  pio_dev_bench(cur_dev, buf, size, write);
+}
+
+void pio_filter(const u16 *types, u08 num)
+{
+  pio_dev_filter(cur_dev, types, num);
+}
+
+void pio_mcast(const u08 *macs, u08 num)
+{
+  pio_dev_mcast(cur_dev, macs, num);
+}
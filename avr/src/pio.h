@@ -44,14 +44,25 @@
 /* status flags */
 #define PIO_STATUS_VERSION      0
 #define PIO_STATUS_LINK_UP      1 
+#define PIO_STATUS_RX_PAGES     2   // rx buffer size in 256 byte pages
+#define PIO_STATUS_RX_MAX_PAGES 3   // high-water mark of rx buffer use
+#define PIO_STATUS_RX_MAX_PKTS  4   // high-water mark of packets in rx buffer
+#define PIO_STATUS_RX_SPI_OPS   5   // SPI transactions of the last recv
+#define PIO_STATUS_TX_SPI_OPS   6   // SPI transactions of the last send
+
+/* mcast: all groups */
+#define PIO_MCAST_ALL           0xff
 
 /* control ids */
 #define PIO_CONTROL_FLOW        0
+#define PIO_CONTROL_RX_RESET    1   // reset rx high-water marks
 
 /* --- API --- */
 
 extern u08 pio_set_device(u08 id);
-extern u08 pio_init(const u08 mac[6],u08 flags);
+/* rx_pages: rx buffer size in 256 byte pages. the device clamps it and
+   uses the rest of its memory for tx */
+extern u08 pio_init(const u08 mac[6],u08 flags,u08 rx_pages);
 extern void pio_exit(void);
 
 extern u08 pio_send(const u08 *buf, u16 size);
@@ -60,4 +71,47 @@ extern u08 pio_has_recv(void);
 extern u08 pio_status(u08 status_id, u08 *value);
 extern u08 pio_control(u08 control_id, u08 value);
 
+/* --- cut-through streaming ---
+   begin: fetch size of next packet and keep device data port open.
+   the caller then clocks in the packet bytes via SPI (see spi.h)
+   end: close data port and release packet
+*/
+extern u08 pio_recv_begin(u16 *got_size);
+extern void pio_recv_end(void);
+
+/* send_begin: open device tx buffer. the caller then clocks out the packet
+   bytes via SPI (see spi.h)
+   send_end: close tx buffer and transmit size bytes. size 0 drops the packet
+*/
+extern void pio_send_begin(void);
+extern void pio_send_end(u16 size);
+
+/* peek: read the first max_size bytes of the next packet into buf but keep
+   it in the device. got_size is the full packet size.
+   only call if pio_has_recv() is not 0!
+*/
+extern u08 pio_peek(u08 *buf, u16 max_size, u16 *got_size);
+
+/* drop: release the next packet without reading it.
+   only call if pio_has_recv() is not 0!
+*/
+extern void pio_drop(void);
+
+/* bench: write or read size bytes (max 1536) of the device buffer memory
+   without sending. only used to measure the raw transfer rate
+*/
+extern void pio_bench(u08 *buf, u16 size, u08 write);
+
+/* filter: only receive broadcasts of the given eth types. unicasts to our
+   mac always pass. the device may pass more than asked for if its filter
+   can't express the set. num 0 restores the filter given in pio_init()
+*/
+extern void pio_filter(const u16 *types, u08 num);
+
+/* mcast: receive multicasts to the num macs (6 bytes each) in macs.
+   the device may pass more than asked for. num 0 receives none and
+   PIO_MCAST_ALL all multicasts
+*/
+extern void pio_mcast(const u08 *macs, u08 num);
+
 #endif
@@ -31,13 +31,22 @@
 #include "global.h"
 
 /* function pointers */
-typedef u08  (*pio_dev_init_t)(const u08 mac[6],u08 flags);
+typedef u08  (*pio_dev_init_t)(const u08 mac[6],u08 flags,u08 rx_pages);
 typedef void (*pio_dev_exit_t)(void);
 typedef u08  (*pio_dev_send_t)(const u08 *buf, u16 size);
 typedef u08  (*pio_dev_recv_t)(u08 *buf, u16 max_size, u16 *got_size);
 typedef u08  (*pio_dev_has_recv_t)(void);
 typedef u08  (*pio_dev_status_t)(u08 status_id, u08 *value);
 typedef u08  (*pio_dev_control_t)(u08 control_id, u08 value);
+typedef u08  (*pio_dev_recv_begin_t)(u16 *got_size);
+typedef void (*pio_dev_recv_end_t)(void);
+typedef void (*pio_dev_send_begin_t)(void);
+typedef void (*pio_dev_send_end_t)(u16 size);
+typedef u08  (*pio_dev_peek_t)(u08 *buf, u16 max_size, u16 *got_size);
+typedef void (*pio_dev_filter_t)(const u16 *types, u08 num);
+typedef void (*pio_dev_mcast_t)(const u08 *macs, u08 num);
+typedef void (*pio_dev_drop_t)(void);
+typedef void (*pio_dev_bench_t)(u08 *buf, u16 size, u08 write);
 
 /* device structure */
 typedef struct {
@@ -49,6 +58,15 @@ typedef struct {
   pio_dev_has_recv_t  has_recv_f;
   pio_dev_status_t    status_f;
   pio_dev_control_t   control_f;
+  pio_dev_recv_begin_t recv_begin_f;
+  pio_dev_recv_end_t  recv_end_f;
+  pio_dev_send_begin_t send_begin_f;
+  pio_dev_send_end_t  send_end_f;
+  pio_dev_peek_t      peek_f;
+  pio_dev_filter_t    filter_f;
+  pio_dev_mcast_t     mcast_f;
+  pio_dev_drop_t      drop_f;
+  pio_dev_bench_t     bench_f;
 } pio_dev_t;
 
 typedef const pio_dev_t *pio_dev_ptr_t;
@@ -60,10 +78,10 @@ inline const PGM_P pio_dev_name(pio_dev_ptr_t pd)
   return (PGM_P)pgm_read_word(&pd->name);
 }
 
-inline u08 pio_dev_init(pio_dev_ptr_t pd, const u08 mac[6], u08 flags)
+inline u08 pio_dev_init(pio_dev_ptr_t pd, const u08 mac[6], u08 flags, u08 rx_pages)
 {
   pio_dev_init_t init_f = (pio_dev_init_t)pgm_read_word(&pd->init_f);
-  return init_f(mac, flags);
+  return init_f(mac, flags, rx_pages);
 }
 
 inline void pio_dev_exit(pio_dev_ptr_t pd)
@@ -102,4 +120,58 @@ inline u08 pio_dev_control(pio_dev_ptr_t pd, u08 control_id, u08 value)
   return control_f(control_id, value);
 }
 
+inline u08 pio_dev_recv_begin(pio_dev_ptr_t pd, u16 *got_size)
+{
+  pio_dev_recv_begin_t recv_begin_f = (pio_dev_recv_begin_t)pgm_read_word(&pd->recv_begin_f);
+  return recv_begin_f(got_size);
+}
+
+inline void pio_dev_recv_end(pio_dev_ptr_t pd)
+{
+  pio_dev_recv_end_t recv_end_f = (pio_dev_recv_end_t)pgm_read_word(&pd->recv_end_f);
+  recv_end_f();
+}
+
+inline void pio_dev_send_begin(pio_dev_ptr_t pd)
+{
+  pio_dev_send_begin_t send_begin_f = (pio_dev_send_begin_t)pgm_read_word(&pd->send_begin_f);
+  send_begin_f();
+}
+
+inline void pio_dev_send_end(pio_dev_ptr_t pd, u16 size)
+{
+  pio_dev_send_end_t send_end_f = (pio_dev_send_end_t)pgm_read_word(&pd->send_end_f);
+  send_end_f(size);
+}
+
+inline u08 pio_dev_peek(pio_dev_ptr_t pd, u08 *buf, u16 max_size, u16 *got_size)
+{
+  pio_dev_peek_t peek_f = (pio_dev_peek_t)pgm_read_word(&pd->peek_f);
+  return peek_f(buf, max_size, got_size);
+}
+
+inline void pio_dev_filter(pio_dev_ptr_t pd, const u16 *types, u08 num)
+{
+  pio_dev_filter_t filter_f = (pio_dev_filter_t)pgm_read_word(&pd->filter_f);
+  filter_f(types, num);
+}
+
+inline void pio_dev_mcast(pio_dev_ptr_t pd, const u08 *macs, u08 num)
+{
+  pio_dev_mcast_t mcast_f = (pio_dev_mcast_t)pgm_read_word(&pd->mcast_f);
+  mcast_f(macs, num);
+}
+
+inline void pio_dev_drop(pio_dev_ptr_t pd)
+{
+  pio_dev_drop_t drop_f = (pio_dev_drop_t)pgm_read_word(&pd->drop_f);
+  drop_f();
+}
+
+inline void pio_dev_bench(pio_dev_ptr_t pd, u08 *buf, u16 size, u08 write)
+{
+  pio_dev_bench_t bench_f = (pio_dev_bench_t)pgm_read_word(&pd->bench_f);
+  bench_f(buf, size, write);
+}
+
 #endif
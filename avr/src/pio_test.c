@@ -33,6 +33,42 @@
 #include "main.h"
 #include "stats.h"
 #include "cmd.h"
+#include "timer.h"
+#include "pkt_buf.h"
+
+#define BENCH_SIZE    1024
+#define BENCH_ROUNDS  16
+
+static u16 bench_run(u08 write)
+{
+  timer_hw_reset();
+  for(u08 i=0;i<BENCH_ROUNDS;i++) {
+    pio_bench(pkt_buf, BENCH_SIZE, write);
+  }
+  return timer_hw_get();
+}
+
+static void bench_show(u16 delta)
+{
+  uart_send_rate_kbs(timer_hw_calc_rate_kbs(BENCH_SIZE * BENCH_ROUNDS, delta));
+}
+
+void pio_test_bench(void)
+{
+  if(run_mode != RUN_MODE_PIO_TEST) {
+    return;
+  }
+
+  u16 wr = bench_run(1);
+  u16 rd = bench_run(0);
+
+  uart_send_time_stamp_spc();
+  uart_send_pstring(PSTR("[PIO_TEST] bench wr "));
+  bench_show(wr);
+  uart_send_pstring(PSTR(" rd "));
+  bench_show(rd);
+  uart_send_crlf();
+}
 
 u08 pio_test_loop(void)
 {
@@ -41,7 +77,7 @@ u08 pio_test_loop(void)
   uart_send_time_stamp_spc();
   uart_send_pstring(PSTR("[PIO_TEST] on\r\n"));
 
-  pio_init(param.mac_addr, pio_util_get_init_flags());
+  pio_init(param.mac_addr, pio_util_get_init_flags(), param.rx_pages);
   stats_reset();
   
   while(run_mode == RUN_MODE_PIO_TEST) {
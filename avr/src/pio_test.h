@@ -30,5 +30,6 @@
 #include "global.h"
 
 extern u08 pio_test_loop(void);
+extern void pio_test_bench(void);
 
 #endif
@@ -54,6 +54,35 @@ u08 pio_util_get_init_flags()
   return flags;
 }
 
+void pio_util_dump_rx_level(void)
+{
+  u08 pages, max_pages, max_pkts;
+  pio_status(PIO_STATUS_RX_PAGES, &pages);
+  pio_status(PIO_STATUS_RX_MAX_PAGES, &max_pages);
+  pio_status(PIO_STATUS_RX_MAX_PKTS, &max_pkts);
+
+  uart_send_pstring(PSTR("rx buf pages "));
+  uart_send_hex_byte(pages);
+  uart_send_pstring(PSTR(" max "));
+  uart_send_hex_byte(max_pages);
+  uart_send_pstring(PSTR(" pkts "));
+  uart_send_hex_byte(max_pkts);
+  uart_send_crlf();
+}
+
+void pio_util_dump_spi_ops(void)
+{
+  u08 rx_ops, tx_ops;
+  pio_status(PIO_STATUS_RX_SPI_OPS, &rx_ops);
+  pio_status(PIO_STATUS_TX_SPI_OPS, &tx_ops);
+
+  uart_send_pstring(PSTR("spi ops last rx "));
+  uart_send_hex_byte(rx_ops);
+  uart_send_pstring(PSTR(" tx "));
+  uart_send_hex_byte(tx_ops);
+  uart_send_crlf();
+}
+
 u08 pio_util_recv_packet(u16 *size)
 {
   // measure packet receive
@@ -62,7 +91,7 @@ u08 pio_util_recv_packet(u16 *size)
   u16 delta = timer_hw_get();
 
   u16 s = *size;
-  u16 rate = timer_hw_calc_rate_kbs(s, delta);
+  u32 rate = timer_hw_calc_rate_kbs(s, delta);
   if(result == PIO_OK) {
     stats_update_ok(STATS_ID_PIO_RX, s, rate);
   } else {
@@ -90,13 +119,41 @@ u08 pio_util_recv_packet(u16 *size)
   return result;
 }
 
+u08 pio_util_recv_stream(u16 *size)
+{
+  u08 result = pio_recv_begin(size);
+
+  // no data moved yet: no rate available
+  u16 s = *size;
+  if(result == PIO_OK) {
+    stats_update_ok(STATS_ID_PIO_RX, s, 0);
+  } else {
+    stats_get(STATS_ID_PIO_RX)->err++;
+  }
+
+  if(global_verbose) {
+    uart_send_time_stamp_spc();
+    uart_send_pstring(PSTR("pio rx: "));
+    if(result == PIO_OK) {
+      uart_send_pstring(PSTR("stream n="));
+      uart_send_hex_word(s);
+      uart_send_crlf();
+    } else {
+      uart_send_pstring(PSTR("ERROR="));
+      uart_send_hex_byte(result);
+      uart_send_crlf();
+    }
+  }
+  return result;
+}
+
 u08 pio_util_send_packet(u16 size)
 {
   timer_hw_reset();
   u08 result = pio_send(pkt_buf, size);
   u16 delta = timer_hw_get();
 
-  u16 rate = timer_hw_calc_rate_kbs(size, delta);
+  u32 rate = timer_hw_calc_rate_kbs(size, delta);
   if(result == PIO_OK) {
     stats_update_ok(STATS_ID_PIO_TX, size, rate);
   } else {
@@ -124,6 +181,24 @@ u08 pio_util_send_packet(u16 size)
   return result;
 }
 
+void pio_util_send_stream(u16 size)
+{
+  pio_send_end(size);
+  if(size == 0) {
+    return;
+  }
+
+  // data already moved with the pb transfer: no rate available
+  stats_update_ok(STATS_ID_PIO_TX, size, 0);
+
+  if(global_verbose) {
+    uart_send_time_stamp_spc();
+    uart_send_pstring(PSTR("pio tx: stream n="));
+    uart_send_hex_word(size);
+    uart_send_crlf();
+  }
+}
+
 u08 pio_util_handle_arp(u16 size)
 {
   u16 type = eth_get_pkt_type(pkt_buf);
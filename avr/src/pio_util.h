@@ -32,6 +32,10 @@
 /* get the configured init flags for PIO */
 extern u08 pio_util_get_init_flags(void);
 
+/* show rx buffer size and its high-water marks */
+extern void pio_util_dump_rx_level(void);
+extern void pio_util_dump_spi_ops(void);
+
 /* receive packet from current PIO and store in pkt_buf.
    also update stats and is verbose if enabled.
    only call if pio_has_recv() ist not 0!
@@ -39,12 +43,25 @@ extern u08 pio_util_get_init_flags(void);
 */
 extern u08 pio_util_recv_packet(u16 *size);
 
+/* open next packet of current PIO for cut-through streaming.
+   the data is not copied to pkt_buf but read by pb_proto directly.
+   also update stats and is verbose if enabled.
+   returns packet size and pio status.
+*/
+extern u08 pio_util_recv_stream(u16 *size);
+
 /* send packet to current PIO from pkt_buf
    aöso updates stats and is verbose if enabled.
    return pio status.
 */
 extern u08 pio_util_send_packet(u16 size);
 
+/* close the PIO tx buffer filled by pb_proto (cut-through) and
+   transmit size bytes. size 0 drops the packet.
+   also update stats and is verbose if enabled.
+*/
+extern void pio_util_send_stream(u16 size);
+
 /* check current packet in pkt_buf if its an ARP packet.
    return 1 if its ARP.
    if its an ARP request for me then reply it and
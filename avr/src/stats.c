@@ -38,11 +38,12 @@ void stats_reset(void)
     s->cnt = 0;
     s->err = 0;
     s->drop = 0;
+    s->crc = 0;
     s->max_rate = 0;
   }
 }
 
-void stats_update_ok(u08 id, u16 size, u16 rate)
+void stats_update_ok(u08 id, u16 size, u32 rate)
 {
   stats_t *s = &stats[id];
   s->cnt++;
@@ -64,6 +65,8 @@ static void dump_line(u08 id)
   uart_send_spc();
   uart_send_hex_word(s->drop);
   uart_send_spc();
+  uart_send_hex_word(s->crc);
+  uart_send_spc();
   uart_send_rate_kbs(s->max_rate);
   uart_send_spc();
 
@@ -90,7 +93,7 @@ static void dump_line(u08 id)
 
 static void dump_header(void)
 {
-  uart_send_pstring(PSTR("cnt  bytes    err  drop rate\r\n"));  
+  uart_send_pstring(PSTR("cnt  bytes    err  drop crc  rate\r\n"));  
 }
 
 void stats_dump_all(void)
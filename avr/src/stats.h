@@ -40,7 +40,8 @@ typedef struct {
   u16 cnt;
   u16 err;
   u16 drop;
-  u16 max_rate;
+  u16 crc;
+  u32 max_rate;
 } stats_t;
 
 extern stats_t stats[STATS_ID_NUM];
@@ -48,7 +49,7 @@ extern stats_t stats[STATS_ID_NUM];
 extern void stats_reset(void);
 extern void stats_dump_all(void);
 extern void stats_dump(u08 pb, u08 pio);
-extern void stats_update_ok(u08 id, u16 size, u16 rate);
+extern void stats_update_ok(u08 id, u16 size, u32 rate);
 
 inline stats_t *stats_get(u08 id)
 {